@@ -0,0 +1,446 @@
+#pragma once
+
+/*
+ * Packed asset archive.
+ *
+ * Layout (all integers little-endian):
+ *   ArchiveHeader
+ *   entry payloads, each starting on a kArchiveAlignment boundary
+ *   ArchiveEntry[EntryCount], sorted by Id
+ *
+ * Assets are addressed by AssetId, the FNV-1a hash of their path relative to the assets directory
+ * (forward slashes). The runtime maps the whole file once and hands out views straight into the
+ * mapping; only entries packed with kEntryCompressed are copied (decompressed once, then cached).
+ */
+
+#ifdef _WIN32
+    #include <Windows.h>
+#else
+    #include <fcntl.h>
+    #include <sys/mman.h>
+    #include <sys/stat.h>
+    #include <unistd.h>
+#endif
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <mutex>
+#include <optional>
+#include <span>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+using AssetId = uint64_t;
+
+static constexpr char kArchiveMagic[4]      = {'P', 'A', 'K', '1'};
+static constexpr uint32_t kArchiveVersion   = 1;
+static constexpr uint64_t kArchiveAlignment = 16;
+static constexpr uint32_t kEntryCompressed  = 1 << 0;
+
+#pragma pack(push, 1)
+struct ArchiveHeader {
+    char Magic[4];
+    uint32_t Version;
+    uint32_t EntryCount;
+    uint32_t Reserved;
+    uint64_t IndexOffset;
+    uint64_t IndexChecksum;
+};
+
+struct ArchiveEntry {
+    AssetId Id;
+    uint64_t Offset;
+    uint64_t StoredSize;
+    uint64_t Size;
+    uint64_t Checksum;  // FNV-1a of the stored (possibly compressed) bytes
+    uint32_t Flags;
+    uint32_t Reserved;
+};
+#pragma pack(pop)
+
+static_assert(sizeof(ArchiveHeader) == 32);
+static_assert(sizeof(ArchiveEntry) == 48);
+
+constexpr uint64_t Fnv1a(const std::span<const uint8_t> data) {
+    uint64_t hash = 0xCBF29CE484222325ull;
+    for (const auto byte : data) {
+        hash ^= byte;
+        hash *= 0x100000001B3ull;
+    }
+    return hash;
+}
+
+constexpr AssetId AssetIdOf(const std::string_view path) {
+    uint64_t hash = 0xCBF29CE484222325ull;
+    for (const auto c : path) {
+        hash ^= static_cast<uint8_t>(c);
+        hash *= 0x100000001B3ull;
+    }
+    return hash;
+}
+
+/*
+ * LZ4 block format (no frame). Sequences are: token, literal length extension, literals, 16-bit
+ * match offset, match length extension. The last sequence carries literals only.
+ */
+namespace Lz4 {
+    static constexpr size_t kMinMatch     = 4;
+    static constexpr size_t kLastLiterals = 5;
+    static constexpr size_t kMatchLimit   = 12;
+    static constexpr int kHashBits        = 12;
+
+    inline uint32_t Read32(const uint8_t* p) {
+        uint32_t value;
+        std::memcpy(&value, p, sizeof(value));
+        return value;
+    }
+
+    inline void WriteLength(std::vector<uint8_t>& out, size_t length) {
+        while (length >= 255) {
+            out.push_back(255);
+            length -= 255;
+        }
+        out.push_back(static_cast<uint8_t>(length));
+    }
+
+    inline void WriteSequence(std::vector<uint8_t>& out,
+                              const uint8_t* literals,
+                              const size_t literalLength,
+                              const size_t offset,
+                              const size_t matchLength) {
+        const size_t matchCode = matchLength ? matchLength - kMinMatch : 0;
+        const auto token       = static_cast<uint8_t>((std::min<size_t>(literalLength, 15) << 4) |
+                                                std::min<size_t>(matchCode, 15));
+        out.push_back(token);
+        if (literalLength >= 15) {
+            WriteLength(out, literalLength - 15);
+        }
+        out.insert(out.end(), literals, literals + literalLength);
+
+        if (matchLength == 0) {
+            return;
+        }
+
+        out.push_back(static_cast<uint8_t>(offset & 0xFF));
+        out.push_back(static_cast<uint8_t>(offset >> 8));
+        if (matchCode >= 15) {
+            WriteLength(out, matchCode - 15);
+        }
+    }
+
+    inline std::vector<uint8_t> Compress(const std::span<const uint8_t> input) {
+        std::vector<uint8_t> out;
+        out.reserve(input.size() + input.size() / 255 + 16);
+
+        const uint8_t* base = input.data();
+        const size_t size   = input.size();
+        size_t anchor       = 0;
+
+        if (size > kMatchLimit) {
+            std::vector<int64_t> table(1 << kHashBits, -1);
+            const size_t matchStartLimit = size - kMatchLimit;
+            const size_t matchEndLimit   = size - kLastLiterals;
+
+            size_t pos = 0;
+            while (pos < matchStartLimit) {
+                const uint32_t sequence = Read32(base + pos);
+                const uint32_t hash     = (sequence * 2654435761u) >> (32 - kHashBits);
+                const int64_t candidate = table[hash];
+                table[hash]             = static_cast<int64_t>(pos);
+
+                if (candidate < 0 || pos - candidate > 0xFFFF ||
+                    Read32(base + candidate) != sequence) {
+                    ++pos;
+                    continue;
+                }
+
+                size_t matchLength = kMinMatch;
+                while (pos + matchLength < matchEndLimit &&
+                       base[candidate + matchLength] == base[pos + matchLength]) {
+                    ++matchLength;
+                }
+
+                WriteSequence(out, base + anchor, pos - anchor, pos - candidate, matchLength);
+                pos += matchLength;
+                anchor = pos;
+            }
+        }
+
+        WriteSequence(out, base + anchor, size - anchor, 0, 0);
+        return out;
+    }
+
+    // Returns false if the input is malformed or does not decode to exactly `output.size()` bytes
+    inline bool Decompress(const std::span<const uint8_t> input, const std::span<uint8_t> output) {
+        size_t in  = 0;
+        size_t out = 0;
+
+        const auto readLength = [&](size_t& length) {
+            uint8_t byte;
+            do {
+                if (in >= input.size()) {
+                    return false;
+                }
+                byte = input[in++];
+                length += byte;
+            } while (byte == 255);
+            return true;
+        };
+
+        while (in < input.size()) {
+            const uint8_t token  = input[in++];
+            size_t literalLength = token >> 4;
+            if (literalLength == 15 && !readLength(literalLength)) {
+                return false;
+            }
+            if (literalLength > input.size() - in || literalLength > output.size() - out) {
+                return false;
+            }
+            // A sequence may start straight with a match; memcpy must not see a null output then
+            if (literalLength != 0) {
+                std::memcpy(output.data() + out, input.data() + in, literalLength);
+            }
+            in += literalLength;
+            out += literalLength;
+
+            if (in == input.size()) {
+                break;
+            }
+
+            if (input.size() - in < 2) {
+                return false;
+            }
+            const size_t offset = input[in] | (input[in + 1] << 8);
+            in += 2;
+            if (offset == 0 || offset > out) {
+                return false;
+            }
+
+            size_t matchLength = token & 0x0F;
+            if (matchLength == 15 && !readLength(matchLength)) {
+                return false;
+            }
+            matchLength += kMinMatch;
+            if (matchLength > output.size() - out) {
+                return false;
+            }
+
+            // Byte-wise on purpose: matches may overlap the bytes they produce
+            for (size_t i = 0; i < matchLength; ++i, ++out) {
+                output[out] = output[out - offset];
+            }
+        }
+
+        return out == output.size();
+    }
+}  // namespace Lz4
+
+class AssetError final : public std::exception {
+public:
+    explicit AssetError(std::string msg) : message(std::move(msg)) {}
+
+    [[nodiscard]] const char* what() const noexcept override {
+        return message.c_str();
+    }
+
+private:
+    std::string message;
+};
+
+class AssetArchive {
+public:
+    AssetArchive() = default;
+
+    AssetArchive(const AssetArchive&)            = delete;
+    AssetArchive& operator=(const AssetArchive&) = delete;
+
+    ~AssetArchive() {
+        Close();
+    }
+
+    // Maps the archive and validates its header, index and payloads. Throws AssetError on failure.
+    void Open(const char* path) {
+        Close();
+        Map(path);
+
+        try {
+            Validate();
+        } catch (...) {
+            Close();
+            throw;
+        }
+    }
+
+    void Close() {
+        if (m_Base) {
+#ifdef _WIN32
+            ::UnmapViewOfFile(m_Base);
+#else
+            ::munmap(const_cast<uint8_t*>(m_Base), m_Size);
+#endif
+        }
+
+        m_Base    = nullptr;
+        m_Size    = 0;
+        m_Entries = {};
+
+        std::lock_guard lock(m_CacheMutex);
+        m_Decompressed.clear();
+    }
+
+    [[nodiscard]] bool Contains(const AssetId id) const {
+        return Find(id) != nullptr;
+    }
+
+    // Returns a view of the asset's bytes, valid until the archive is closed
+    [[nodiscard]] std::optional<std::span<const uint8_t>> Get(const AssetId id) {
+        const ArchiveEntry* entry = Find(id);
+        if (!entry) {
+            return std::nullopt;
+        }
+
+        const auto stored = std::span(m_Base + entry->Offset, entry->StoredSize);
+        if (!(entry->Flags & kEntryCompressed)) {
+            return stored;
+        }
+
+        std::lock_guard lock(m_CacheMutex);
+        auto& data = m_Decompressed[id];
+        if (data.size() != entry->Size) {
+            data.resize(entry->Size);
+            if (!Lz4::Decompress(stored, data)) {
+                m_Decompressed.erase(id);
+                return std::nullopt;
+            }
+        }
+
+        return std::span<const uint8_t>(data);
+    }
+
+private:
+    const uint8_t* m_Base = nullptr;
+    size_t m_Size         = 0;
+    std::span<const ArchiveEntry> m_Entries;
+
+    std::mutex m_CacheMutex;
+    std::unordered_map<AssetId, std::vector<uint8_t>> m_Decompressed;
+
+    void Map(const char* path) {
+#ifdef _WIN32
+        const HANDLE file = ::CreateFileA(path,
+                                          GENERIC_READ,
+                                          FILE_SHARE_READ,
+                                          nullptr,
+                                          OPEN_EXISTING,
+                                          FILE_ATTRIBUTE_NORMAL,
+                                          nullptr);
+        if (file == INVALID_HANDLE_VALUE) {
+            throw AssetError(std::string("Failed to open asset archive: ") + path);
+        }
+
+        LARGE_INTEGER fileSize;
+        if (!::GetFileSizeEx(file, &fileSize) || fileSize.QuadPart == 0) {
+            ::CloseHandle(file);
+            throw AssetError(std::string("Asset archive is empty: ") + path);
+        }
+
+        const HANDLE mapping = ::CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+        ::CloseHandle(file);
+        if (!mapping) {
+            throw AssetError(std::string("Failed to map asset archive: ") + path);
+        }
+
+        // The view keeps the mapping alive on its own
+        const void* view = ::MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+        ::CloseHandle(mapping);
+        if (!view) {
+            throw AssetError(std::string("Failed to map asset archive: ") + path);
+        }
+
+        m_Base = static_cast<const uint8_t*>(view);
+        m_Size = static_cast<size_t>(fileSize.QuadPart);
+#else
+        const int fd = ::open(path, O_RDONLY);
+        if (fd < 0) {
+            throw AssetError(std::string("Failed to open asset archive: ") + path);
+        }
+
+        struct stat info = {};
+        if (::fstat(fd, &info) != 0 || info.st_size == 0) {
+            ::close(fd);
+            throw AssetError(std::string("Asset archive is empty: ") + path);
+        }
+
+        const auto size = static_cast<size_t>(info.st_size);
+        void* view      = ::mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+        ::close(fd);
+        if (view == MAP_FAILED) {
+            throw AssetError(std::string("Failed to map asset archive: ") + path);
+        }
+
+        m_Base = static_cast<const uint8_t*>(view);
+        m_Size = size;
+#endif
+    }
+
+    void Validate() {
+        if (m_Size < sizeof(ArchiveHeader)) {
+            throw AssetError("Asset archive is truncated");
+        }
+
+        ArchiveHeader header;
+        std::memcpy(&header, m_Base, sizeof(header));
+        if (std::memcmp(header.Magic, kArchiveMagic, sizeof(kArchiveMagic)) != 0) {
+            throw AssetError("Not an asset archive");
+        }
+        if (header.Version != kArchiveVersion) {
+            throw AssetError("Unsupported asset archive version");
+        }
+
+        const uint64_t indexSize = static_cast<uint64_t>(header.EntryCount) * sizeof(ArchiveEntry);
+        if (header.IndexOffset % alignof(uint64_t) != 0 || header.IndexOffset > m_Size ||
+            indexSize > m_Size - header.IndexOffset) {
+            throw AssetError("Asset archive index is out of bounds");
+        }
+
+        const auto indexBytes = std::span(m_Base + header.IndexOffset, indexSize);
+        if (Fnv1a(indexBytes) != header.IndexChecksum) {
+            throw AssetError("Asset archive index is corrupt");
+        }
+
+        m_Entries = std::span(reinterpret_cast<const ArchiveEntry*>(indexBytes.data()),
+                              header.EntryCount);
+
+        for (size_t i = 0; i < m_Entries.size(); ++i) {
+            const auto& entry = m_Entries[i];
+            if (i > 0 && m_Entries[i - 1].Id >= entry.Id) {
+                throw AssetError("Asset archive index is not sorted");
+            }
+            if (entry.Offset < sizeof(ArchiveHeader) || entry.Offset > header.IndexOffset ||
+                entry.StoredSize > header.IndexOffset - entry.Offset) {
+                throw AssetError("Asset archive entry is out of bounds");
+            }
+            if (entry.Offset % kArchiveAlignment != 0) {
+                throw AssetError("Asset archive entry is misaligned");
+            }
+            if (!(entry.Flags & kEntryCompressed) && entry.StoredSize != entry.Size) {
+                throw AssetError("Asset archive entry has an invalid size");
+            }
+            if (Fnv1a(std::span(m_Base + entry.Offset, entry.StoredSize)) != entry.Checksum) {
+                throw AssetError("Asset archive entry is corrupt");
+            }
+        }
+    }
+
+    [[nodiscard]] const ArchiveEntry* Find(const AssetId id) const {
+        const auto it = std::ranges::lower_bound(m_Entries, id, {}, &ArchiveEntry::Id);
+        if (it == m_Entries.end() || it->Id != id) {
+            return nullptr;
+        }
+        return &*it;
+    }
+};
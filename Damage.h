@@ -0,0 +1,174 @@
+#pragma once
+
+#include "Math.h"
+
+#include <array>
+#include <cmath>
+#include <cstdint>
+#include <span>
+
+/*
+ * Screen damage for incremental rendering. Objects report what they painted last frame and what
+ * they will paint this frame; the renderer then clears and repaints only the merged rectangles,
+ * or the whole target once the damage covers most of it anyway.
+ */
+
+// Whole device pixels. Areas of these overflow Scalar, so they are kept apart from Rect.
+using PixelRect = BasicRect<int>;
+
+// Smallest pixel rect containing `rect`, grown by a pixel for antialiased edges
+inline PixelRect ToPixelRect(const Rect& rect) {
+    return {static_cast<int>(std::floor(static_cast<float>(rect.Left))) - 1,
+            static_cast<int>(std::floor(static_cast<float>(rect.Top))) - 1,
+            static_cast<int>(std::ceil(static_cast<float>(rect.Right))) + 1,
+            static_cast<int>(std::ceil(static_cast<float>(rect.Bottom))) + 1};
+}
+
+inline Rect ToRect(const PixelRect& rect) {
+    return {Scalar(rect.Left), Scalar(rect.Top), Scalar(rect.Right), Scalar(rect.Bottom)};
+}
+
+inline int64_t Area(const PixelRect& rect) {
+    if (rect.Right <= rect.Left || rect.Bottom <= rect.Top) {
+        return 0;
+    }
+    return static_cast<int64_t>(rect.Right - rect.Left) * (rect.Bottom - rect.Top);
+}
+
+inline PixelRect Union(const PixelRect& rectA, const PixelRect& rectB) {
+    return {rectA.Left < rectB.Left ? rectA.Left : rectB.Left,
+            rectA.Top < rectB.Top ? rectA.Top : rectB.Top,
+            rectA.Right > rectB.Right ? rectA.Right : rectB.Right,
+            rectA.Bottom > rectB.Bottom ? rectA.Bottom : rectB.Bottom};
+}
+
+inline PixelRect Intersection(const PixelRect& rectA, const PixelRect& rectB) {
+    return {rectA.Left > rectB.Left ? rectA.Left : rectB.Left,
+            rectA.Top > rectB.Top ? rectA.Top : rectB.Top,
+            rectA.Right < rectB.Right ? rectA.Right : rectB.Right,
+            rectA.Bottom < rectB.Bottom ? rectA.Bottom : rectB.Bottom};
+}
+
+class DamageRegion {
+public:
+    // Each rect costs a clip push and a pass over the objects, so keep only a few
+    static constexpr size_t kMaxRects = 8;
+
+    // Past this share of the target a single full clear is cheaper than many partial ones
+    static constexpr double kFullRedrawCoverage = 0.5;
+
+    // Starts a new frame on a `width` x `height` target. A pending InvalidateAll carries over.
+    void Begin(const int width, const int height) {
+        const PixelRect surface = {0, 0, width, height};
+        if (surface != m_Surface) {
+            m_Surface     = surface;
+            m_Invalidated = true;  // Resized: nothing that was on screen can be trusted
+        }
+
+        m_IsFull      = m_Invalidated;
+        m_Invalidated = false;
+        m_Count       = 0;
+    }
+
+    // Forces a full redraw on the next frame (first frame, resize, WM_PAINT)
+    void InvalidateAll() {
+        m_Invalidated = true;
+    }
+
+    void Add(const PixelRect& rect) {
+        if (m_IsFull) {
+            return;
+        }
+
+        PixelRect merged = Intersection(rect, m_Surface);
+        if (Area(merged) == 0) {
+            return;
+        }
+
+        // Fold in every rect that costs no more to paint together than apart. Growing `merged`
+        // can make it worth absorbing rects that were skipped earlier, so rescan until stable.
+        for (bool changed = true; changed;) {
+            changed = false;
+            for (size_t i = 0; i < m_Count; ++i) {
+                const PixelRect candidate = Union(merged, m_Rects[i]);
+                if (Area(candidate) <= Area(merged) + Area(m_Rects[i])) {
+                    merged     = candidate;
+                    m_Rects[i] = m_Rects[--m_Count];
+                    changed    = true;
+                    break;
+                }
+            }
+        }
+
+        if (m_Count == kMaxRects) {
+            MergeCheapestInto(merged);
+        }
+        m_Rects[m_Count++] = merged;
+
+        if (static_cast<double>(PixelsTouched()) > kFullRedrawCoverage * Area(m_Surface)) {
+            m_IsFull = true;
+        }
+    }
+
+    // Damages where something was painted and where it is painted now, unless it stayed put
+    void AddMove(const Rect& before, const Rect& after) {
+        if (before != after) {
+            Add(ToPixelRect(before));
+            Add(ToPixelRect(after));
+        }
+    }
+
+    [[nodiscard]] bool IsFullRedraw() const {
+        return m_IsFull;
+    }
+
+    [[nodiscard]] bool IsEmpty() const {
+        return !m_IsFull && m_Count == 0;
+    }
+
+    // Only meaningful when !IsFullRedraw()
+    [[nodiscard]] std::span<const PixelRect> Rects() const {
+        return {m_Rects.data(), m_Count};
+    }
+
+    [[nodiscard]] PixelRect Surface() const {
+        return m_Surface;
+    }
+
+    // Pixels cleared and repainted this frame. Overlapping rects are counted twice, as they are
+    // painted twice.
+    [[nodiscard]] int64_t PixelsTouched() const {
+        if (m_IsFull) {
+            return Area(m_Surface);
+        }
+
+        int64_t total = 0;
+        for (size_t i = 0; i < m_Count; ++i) {
+            total += Area(m_Rects[i]);
+        }
+        return total;
+    }
+
+private:
+    std::array<PixelRect, kMaxRects> m_Rects = {};
+    size_t m_Count                           = 0;
+    PixelRect m_Surface                      = {};
+    bool m_IsFull                            = true;
+    bool m_Invalidated                       = true;
+
+    // Out of slots: merges `rect` with whichever stored rect grows the least, freeing that slot
+    void MergeCheapestInto(PixelRect& rect) {
+        size_t best        = 0;
+        int64_t bestGrowth = INT64_MAX;
+        for (size_t i = 0; i < m_Count; ++i) {
+            const int64_t growth = Area(Union(rect, m_Rects[i])) - Area(rect) - Area(m_Rects[i]);
+            if (growth < bestGrowth) {
+                best       = i;
+                bestGrowth = growth;
+            }
+        }
+
+        rect          = Union(rect, m_Rects[best]);
+        m_Rects[best] = m_Rects[--m_Count];
+    }
+};
@@ -0,0 +1,169 @@
+#pragma once
+
+#include <compare>
+#include <concepts>
+#include <cstdint>
+
+/*
+ * Q16.16 fixed-point scalar. All arithmetic is done on the raw integer so the simulation produces
+ * bit-identical results regardless of compiler flags, FPU mode or CPU.
+ */
+struct Fixed {
+    static constexpr int kFracBits = 16;
+    static constexpr int32_t kOne  = 1 << kFracBits;
+
+    int32_t Raw = 0;
+
+    constexpr Fixed() = default;
+
+    template<std::integral I>
+    constexpr Fixed(const I value) : Raw(static_cast<int32_t>(value) * kOne) {}
+
+    // Only meant for constants and for converting values that come from outside the simulation
+    template<std::floating_point F>
+    explicit constexpr Fixed(const F value)
+        : Raw(static_cast<int32_t>(value * static_cast<F>(kOne) +
+                                   (value < F(0) ? F(-0.5) : F(0.5)))) {}
+
+    static constexpr Fixed FromRaw(const int32_t raw) {
+        Fixed result;
+        result.Raw = raw;
+        return result;
+    }
+
+    explicit constexpr operator float() const {
+        return static_cast<float>(Raw) / static_cast<float>(kOne);
+    }
+
+    explicit constexpr operator int() const {
+        return Raw >> kFracBits;
+    }
+
+    constexpr Fixed operator-() const {
+        return FromRaw(-Raw);
+    }
+
+    friend constexpr Fixed operator+(const Fixed lhs, const Fixed rhs) {
+        return FromRaw(lhs.Raw + rhs.Raw);
+    }
+
+    friend constexpr Fixed operator-(const Fixed lhs, const Fixed rhs) {
+        return FromRaw(lhs.Raw - rhs.Raw);
+    }
+
+    friend constexpr Fixed operator*(const Fixed lhs, const Fixed rhs) {
+        const int64_t product = static_cast<int64_t>(lhs.Raw) * rhs.Raw;
+        return FromRaw(static_cast<int32_t>(product >> kFracBits));
+    }
+
+    friend constexpr Fixed operator/(const Fixed lhs, const Fixed rhs) {
+        const int64_t dividend = static_cast<int64_t>(lhs.Raw) * kOne;
+        return FromRaw(static_cast<int32_t>(dividend / rhs.Raw));
+    }
+
+    constexpr Fixed& operator+=(const Fixed rhs) {
+        return *this = *this + rhs;
+    }
+
+    constexpr Fixed& operator-=(const Fixed rhs) {
+        return *this = *this - rhs;
+    }
+
+    constexpr Fixed& operator*=(const Fixed rhs) {
+        return *this = *this * rhs;
+    }
+
+    constexpr Fixed& operator/=(const Fixed rhs) {
+        return *this = *this / rhs;
+    }
+
+    friend constexpr bool operator==(const Fixed& lhs, const Fixed& rhs)  = default;
+    friend constexpr auto operator<=>(const Fixed& lhs, const Fixed& rhs) = default;
+};
+
+static_assert(Fixed(3) * Fixed(2) == Fixed(6));
+static_assert(Fixed(-3) / Fixed(2) == Fixed(-1.5f));
+static_assert(Fixed(0.5f) * Fixed(0.5f) == Fixed(0.25f));
+
+// Scalar type used by the simulation. Switch to float to get the old (non-deterministic) behaviour.
+using Scalar = Fixed;
+
+template<typename T>
+struct BasicVector2 {
+    T X = T(0);
+    T Y = T(0);
+
+    constexpr BasicVector2 operator-() const {
+        return {-X, -Y};
+    }
+
+    constexpr BasicVector2 operator+(const BasicVector2& rhs) const {
+        return {X + rhs.X, Y + rhs.Y};
+    }
+
+    constexpr BasicVector2 operator-(const BasicVector2& rhs) const {
+        return {X - rhs.X, Y - rhs.Y};
+    }
+
+    constexpr BasicVector2 operator*(const BasicVector2& rhs) const {
+        return {X * rhs.X, Y * rhs.Y};
+    }
+
+    constexpr BasicVector2 operator*(const T scalar) const {
+        return {X * scalar, Y * scalar};
+    }
+
+    constexpr BasicVector2& operator+=(const BasicVector2& rhs) {
+        return *this = *this + rhs;
+    }
+
+    constexpr bool operator==(const BasicVector2& rhs) const = default;
+
+    static constexpr T Dot(const BasicVector2& lhs, const BasicVector2& rhs) {
+        return lhs.X * rhs.X + lhs.Y * rhs.Y;
+    }
+
+    static constexpr BasicVector2 Reflect(const BasicVector2& velocity,
+                                          const BasicVector2& normal) {
+        const T dotProduct = Dot(velocity, normal);
+        BasicVector2 reflection;
+        reflection.X = velocity.X - T(2) * dotProduct * normal.X;
+        reflection.Y = velocity.Y - T(2) * dotProduct * normal.Y;
+        return reflection;
+    }
+};
+
+template<typename T>
+struct BasicRect {
+    T Left   = T(0);
+    T Top    = T(0);
+    T Right  = T(0);
+    T Bottom = T(0);
+
+    constexpr bool operator==(const BasicRect& rhs) const = default;
+
+    // Builds a rect centered on `center`, extending `halfSize` in each direction
+    static constexpr BasicRect FromCenter(const BasicVector2<T>& center,
+                                          const BasicVector2<T>& halfSize) {
+        return {center.X - halfSize.X,
+                center.Y - halfSize.Y,
+                center.X + halfSize.X,
+                center.Y + halfSize.Y};
+    }
+};
+
+template<typename T>
+constexpr bool Overlaps(const BasicRect<T>& rectA, const BasicRect<T>& rectB) {
+    if (rectA.Right <= rectB.Left || rectB.Right <= rectA.Left) {
+        return false;
+    }
+
+    if (rectA.Bottom <= rectB.Top || rectB.Bottom <= rectA.Top) {
+        return false;
+    }
+
+    return true;
+}
+
+using Vector2 = BasicVector2<Scalar>;
+using Rect    = BasicRect<Scalar>;
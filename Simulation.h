@@ -0,0 +1,176 @@
+#pragma once
+
+#include "Math.h"
+
+/*
+ * Game rules shared by the windowed game and the headless servers/tools. Nothing in here depends
+ * on the platform, so every build runs the exact same (fixed-point) physics.
+ */
+
+// Tuning in game units per fixed update, for any scalar type
+template<typename T>
+struct Tuning {
+    static constexpr T InitBallSpeed = T(10);
+    static constexpr T BallSpeedup   = T(1.05f);
+    static constexpr T PaddleStep    = T(10);
+    static constexpr T PaddleSpeed   = T(100);
+};
+
+static constexpr Scalar kInitBallSpeed = Tuning<Scalar>::InitBallSpeed;
+static constexpr Scalar kBallSpeedup   = Tuning<Scalar>::BallSpeedup;
+static constexpr Scalar kPaddleStep    = Tuning<Scalar>::PaddleStep;
+static constexpr Scalar kPaddleSpeed   = Tuning<Scalar>::PaddleSpeed;
+
+enum class Scorer { None, Player, Opponent };
+
+struct GameState {
+    int PlayerScore   = 0;
+    int OpponentScore = 0;
+    int ScoreLimit    = 0;
+
+    [[nodiscard]] int TotalScore() const {
+        return PlayerScore + OpponentScore;
+    }
+
+    void Reset(const int scoreLimit) {
+        PlayerScore   = 0;
+        PlayerScore   = 0;
+        OpponentScore = 0;
+        ScoreLimit    = scoreLimit;
+    }
+
+    void AddPoint(const Scorer scorer) {
+        if (scorer == Scorer::Player) {
+            PlayerScore++;
+        } else if (scorer == Scorer::Opponent) {
+            OpponentScore++;
+        }
+    }
+};
+
+template<typename T>
+struct BasicBody {
+    BasicRect<T> BoundingBox = {};
+    BasicVector2<T> Position = {};
+    BasicVector2<T> Size     = {};
+    BasicVector2<T> Velocity = {};
+
+    void UpdateBoundingBox() {
+        BoundingBox = BasicRect<T>::FromCenter(Position, Size);
+    }
+};
+
+using Body = BasicBody<Scalar>;
+
+namespace Physics {
+    // The ball is served towards whoever conceded the last point
+    template<typename T>
+    BasicVector2<T> ServeVelocity(const Scorer lastToScore, const T speed) {
+        // TODO: Randomize Y velocity
+        if (lastToScore == Scorer::Player) {
+            return {speed, 0};
+        }
+        return {-speed, 0};
+    }
+
+    template<typename T>
+    void Move(BasicBody<T>& body) {
+        body.Position += body.Velocity;
+    }
+
+    template<typename T>
+    void CollideBall(BasicBody<T>& ball, const BasicBody<T>& paddleA, const BasicBody<T>& paddleB) {
+        // TODO: Implement calculations for reflecting ball off paddle correctly
+        if (Overlaps(ball.BoundingBox, paddleA.BoundingBox) ||
+            Overlaps(ball.BoundingBox, paddleB.BoundingBox)) {
+            ball.Velocity = -ball.Velocity;
+            // increase ball speed
+            ball.Velocity = ball.Velocity * Tuning<T>::BallSpeedup;
+        }
+    }
+
+    // Leaving on the left scores for the opponent, leaving on the right scores for the player
+    template<typename T>
+    Scorer CheckOOB(const BasicBody<T>& ball, const T fieldWidth) {
+        if (ball.Position.X < T(0)) {
+            return Scorer::Opponent;
+        }
+        if (ball.Position.X > fieldWidth) {
+            return Scorer::Player;
+        }
+        return Scorer::None;
+    }
+
+    // direction < 0 moves the paddle up, direction > 0 moves it down
+    template<typename T>
+    void NudgePaddle(BasicBody<T>& paddle, const int direction) {
+        if (direction < 0) {
+            paddle.Position.Y -= Tuning<T>::PaddleStep;
+            paddle.Velocity.Y = -Tuning<T>::PaddleSpeed;
+        } else if (direction > 0) {
+            paddle.Position.Y += Tuning<T>::PaddleStep;
+            paddle.Velocity.Y = Tuning<T>::PaddleSpeed;
+        }
+    }
+}  // namespace Physics
+
+// A whole match without a window: the same objects, layout and fixed update as the game
+template<typename T>
+struct BasicMatch {
+    GameState State;
+    T Width  = T(0);
+    T Height = T(0);
+    BasicBody<T> Ball;
+    BasicBody<T> Player;
+    BasicBody<T> Opponent;
+    Scorer LastToScore = Scorer::None;
+
+    BasicMatch() = default;
+
+    BasicMatch(const T width, const T height, const int scoreLimit)
+        : Width(width), Height(height) {
+        State.Reset(scoreLimit);
+
+        Ball.Size = {16, 16};
+
+        Player.Position = {100, height / 2};
+        Player.Size     = {16, 100};
+
+        Opponent.Position = {width - 100, height / 2};
+        Opponent.Size     = {16, 100};
+
+        ServeBall();
+        Player.UpdateBoundingBox();
+        Opponent.UpdateBoundingBox();
+    }
+
+    void ServeBall() {
+        Ball.Velocity = Physics::ServeVelocity(LastToScore, Tuning<T>::InitBallSpeed);
+        Ball.Position = {Width / 2, Height / 2};
+    }
+
+    [[nodiscard]] bool IsOver() const {
+        return State.TotalScore() >= State.ScoreLimit;
+    }
+
+    // One fixed update. Returns who scored during this step, if anyone.
+    Scorer Tick() {
+        Player.UpdateBoundingBox();
+        Opponent.UpdateBoundingBox();
+
+        Ball.UpdateBoundingBox();
+        Physics::CollideBall(Ball, Player, Opponent);
+
+        const Scorer scorer = Physics::CheckOOB(Ball, Width);
+        if (scorer != Scorer::None) {
+            State.AddPoint(scorer);
+            LastToScore = scorer;
+            ServeBall();
+        }
+
+        Physics::Move(Ball);
+        return scorer;
+    }
+};
+
+using Match = BasicMatch<Scalar>;
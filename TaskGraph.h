@@ -0,0 +1,290 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+class ThreadPool {
+public:
+    explicit ThreadPool(const size_t threadCount, std::function<void()> onThreadStart = {}) {
+        for (size_t i = 0; i < threadCount; ++i) {
+            m_Workers.emplace_back([this, onThreadStart] {
+                if (onThreadStart) {
+                    onThreadStart();
+                }
+                WorkerLoop();
+            });
+        }
+    }
+
+    ThreadPool(const ThreadPool&)            = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    ~ThreadPool() {
+        {
+            std::lock_guard lock(m_Mutex);
+            m_Stopping = true;
+        }
+        m_Condition.notify_all();
+
+        for (auto& worker : m_Workers) {
+            worker.join();
+        }
+    }
+
+    void Enqueue(std::function<void()> job) {
+        {
+            std::lock_guard lock(m_Mutex);
+            m_Jobs.push_back(std::move(job));
+        }
+        m_Condition.notify_one();
+    }
+
+    [[nodiscard]] size_t Size() const {
+        return m_Workers.size();
+    }
+
+private:
+    std::vector<std::thread> m_Workers;
+    std::deque<std::function<void()>> m_Jobs;
+    std::mutex m_Mutex;
+    std::condition_variable m_Condition;
+    bool m_Stopping = false;
+
+    void WorkerLoop() {
+        for (;;) {
+            std::function<void()> job;
+            {
+                std::unique_lock lock(m_Mutex);
+                m_Condition.wait(lock, [this] { return m_Stopping || !m_Jobs.empty(); });
+                if (m_Jobs.empty()) {
+                    return;  // Stopping and drained
+                }
+                job = std::move(m_Jobs.front());
+                m_Jobs.pop_front();
+            }
+            job();
+        }
+    }
+};
+
+struct StageTiming {
+    std::string Name;
+    double StartMs = 0;
+    double EndMs   = 0;
+};
+
+/*
+ * Static dependency graph of one-shot tasks. Tasks are added up front, then Run() starts every task
+ * whose dependencies are met. Pool tasks run on the ThreadPool; main-thread tasks only run inside
+ * Wait() on the thread that calls it. A failing task fails all of its dependents, and Wait()
+ * rethrows the failure.
+ */
+class TaskGraph {
+    struct Node;
+
+public:
+    enum class Affinity { Pool, MainThread };
+
+    class Task {
+    public:
+        Task() = default;
+
+        [[nodiscard]] bool IsReady() const {
+            return m_Future.wait_for(std::chrono::seconds(0)) == std::future_status::ready;
+        }
+
+    private:
+        friend class TaskGraph;
+
+        Node* m_Node = nullptr;
+        std::shared_future<void> m_Future;
+    };
+
+    // Called from whichever thread finished the stage
+    std::function<void(const StageTiming&)> OnStageComplete;
+
+    explicit TaskGraph(ThreadPool& pool) : m_Pool(pool) {}
+
+    TaskGraph(const TaskGraph&)            = delete;
+    TaskGraph& operator=(const TaskGraph&) = delete;
+
+    // Tasks hold a pointer to the graph, so let the ones still in flight finish first
+    ~TaskGraph() {
+        WaitAll();
+    }
+
+    Task Add(std::string name,
+             const std::vector<Task>& dependencies,
+             std::function<void()> work,
+             const Affinity affinity = Affinity::Pool) {
+        auto node     = std::make_unique<Node>();
+        node->Name    = std::move(name);
+        node->Work    = std::move(work);
+        node->RunOn   = affinity;
+        node->Pending = static_cast<int>(dependencies.size());
+
+        for (const auto& dependency : dependencies) {
+            if (!dependency.m_Node) {
+                throw std::invalid_argument("TaskGraph: empty dependency");
+            }
+            dependency.m_Node->Dependents.push_back(node.get());
+        }
+
+        Task task;
+        node->Finished = node->Done.get_future().share();
+        task.m_Node    = node.get();
+        task.m_Future  = node->Finished;
+
+        m_Nodes.push_back(std::move(node));
+        return task;
+    }
+
+    void Run() {
+        m_Epoch   = std::chrono::steady_clock::now();
+        m_Started = true;
+        // Collect the roots first: once scheduling starts, finishing tasks drive Pending to zero too
+        std::vector<Node*> roots;
+        for (const auto& node : m_Nodes) {
+            if (node->Pending == 0) {
+                roots.push_back(node.get());
+            }
+        }
+        for (Node* root : roots) {
+            Schedule(root);
+        }
+    }
+
+    // Runs ready main-thread tasks until `task` has finished, then rethrows its failure if any
+    void Wait(const Task& task) {
+        for (;;) {
+            Node* next = nullptr;
+            {
+                std::unique_lock lock(m_MainMutex);
+                m_MainCondition.wait(lock, [&] { return !m_MainQueue.empty() || task.IsReady(); });
+                if (m_MainQueue.empty()) {
+                    break;
+                }
+                next = m_MainQueue.front();
+                m_MainQueue.pop_front();
+            }
+            Execute(next);
+        }
+
+        task.m_Future.get();
+    }
+
+    // Blocks until every pool task has finished. Main-thread tasks must already have been drained
+    // by Wait(), and failures are not rethrown.
+    void WaitAll() {
+        if (!m_Started) {
+            return;
+        }
+        for (const auto& node : m_Nodes) {
+            node->Finished.wait();
+        }
+        // The last task publishes while holding the lock; wait for it to let go
+        std::lock_guard lock(m_MainMutex);
+    }
+
+    [[nodiscard]] double ElapsedMs() const {
+        return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - m_Epoch)
+          .count();
+    }
+
+    [[nodiscard]] std::vector<StageTiming> Timeline() const {
+        std::lock_guard lock(m_TimelineMutex);
+        return m_Timeline;
+    }
+
+private:
+    struct Node {
+        std::string Name;
+        std::function<void()> Work;
+        Affinity RunOn = Affinity::Pool;
+        std::atomic<int> Pending {0};
+        std::vector<Node*> Dependents;
+        std::exception_ptr Failure;
+        std::promise<void> Done;
+        std::shared_future<void> Finished;
+    };
+
+    ThreadPool& m_Pool;
+    std::vector<std::unique_ptr<Node>> m_Nodes;
+    std::chrono::steady_clock::time_point m_Epoch;
+    bool m_Started = false;
+
+    std::mutex m_MainMutex;
+    std::condition_variable m_MainCondition;
+    std::deque<Node*> m_MainQueue;
+
+    mutable std::mutex m_TimelineMutex;
+    std::vector<StageTiming> m_Timeline;
+
+    void Schedule(Node* node) {
+        if (node->RunOn == Affinity::Pool) {
+            m_Pool.Enqueue([this, node] { Execute(node); });
+            return;
+        }
+
+        {
+            std::lock_guard lock(m_MainMutex);
+            m_MainQueue.push_back(node);
+        }
+        m_MainCondition.notify_all();
+    }
+
+    void Execute(Node* node) {
+        StageTiming timing {node->Name, ElapsedMs()};
+
+        if (!node->Failure) {
+            try {
+                node->Work();
+            } catch (...) {
+                node->Failure = std::current_exception();
+            }
+        }
+
+        timing.EndMs = ElapsedMs();
+        {
+            std::lock_guard lock(m_TimelineMutex);
+            m_Timeline.push_back(timing);
+        }
+        if (OnStageComplete) {
+            OnStageComplete(timing);
+        }
+
+        for (Node* dependent : node->Dependents) {
+            if (node->Failure) {
+                // Written before the decrement below, so the dependent sees it when it runs
+                std::lock_guard lock(m_MainMutex);
+                if (!dependent->Failure) {
+                    dependent->Failure = node->Failure;
+                }
+            }
+            if (--dependent->Pending == 0) {
+                Schedule(dependent);
+            }
+        }
+
+        // Publish and notify under the lock so Wait() cannot miss the wakeup
+        std::lock_guard lock(m_MainMutex);
+        if (node->Failure) {
+            node->Done.set_exception(node->Failure);
+        } else {
+            node->Done.set_value();
+        }
+        m_MainCondition.notify_all();
+    }
+};
@@ -0,0 +1,270 @@
+#include "PongEnv.h"
+
+#include "../Simulation.h"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstring>
+#include <new>
+#include <vector>
+
+// SplitMix64: tiny, fast and good enough to drive the opponent and episode starts
+class Rng {
+public:
+    explicit Rng(const uint64_t seed = 0) : m_State(seed) {}
+
+    uint64_t Next() {
+        uint64_t z = (m_State += 0x9E3779B97F4A7C15ull);
+        z          = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+        z          = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+        return z ^ (z >> 31);
+    }
+
+    // True with probability threshold / 2^32
+    bool Chance(const uint32_t threshold) {
+        return static_cast<uint32_t>(Next() >> 32) < threshold;
+    }
+
+    // Uniform in [-range, range]
+    int Offset(const int range) {
+        return static_cast<int>(Next() % static_cast<uint64_t>(2 * range + 1)) - range;
+    }
+
+private:
+    uint64_t m_State;
+};
+
+struct PongEnv {
+    struct Slot {
+        Match Game;
+        Rng Random;
+        uint32_t Steps  = 0;
+        bool NeedsReset = false;
+    };
+
+    PongEnvConfig Config       = {};
+    uint32_t OpponentThreshold = 0;  // Opponent reacts when a random u32 falls below this
+    size_t FrameSize           = 0;
+    std::vector<Slot> Slots;
+
+    explicit PongEnv(const PongEnvConfig& config) : Config(config), Slots(config.EnvCount) {
+        const double skill = std::clamp(static_cast<double>(config.OpponentSkill), 0.0, 1.0);
+        OpponentThreshold  = static_cast<uint32_t>(skill * 4294967295.0);
+        FrameSize          = static_cast<size_t>(config.PixelWidth) * config.PixelHeight;
+    }
+
+    void StartEpisode(Slot& slot) const {
+        slot.Game  = Match(Config.Width, Config.Height, Config.ScoreLimit);
+        slot.Steps = 0;
+
+        // Vary who serves first and where the paddles start
+        slot.Game.LastToScore = slot.Random.Next() & 1 ? Scorer::Player : Scorer::Opponent;
+        slot.Game.ServeBall();
+
+        const int range = Config.Height / 4;
+        slot.Game.Player.Position.Y += slot.Random.Offset(range);
+        slot.Game.Opponent.Position.Y += slot.Random.Offset(range);
+        slot.Game.Player.UpdateBoundingBox();
+        slot.Game.Opponent.UpdateBoundingBox();
+    }
+
+    // Paddles are kept on the field, or a policy holding one direction would eventually leave the
+    // fixed-point range
+    void KeepOnField(Body& paddle) const {
+        paddle.Position.Y = std::clamp(paddle.Position.Y, Scalar(0), Scalar(Config.Height));
+    }
+
+    // Returns the reward for this step
+    float Advance(Slot& slot, const int32_t action) {
+        Match& game = slot.Game;
+
+        Physics::NudgePaddle(game.Player, action);
+        KeepOnField(game.Player);
+
+        if (slot.Random.Chance(OpponentThreshold)) {
+            const Scalar offset = game.Ball.Position.Y - game.Opponent.Position.Y;
+            if (offset > kPaddleStep) {
+                Physics::NudgePaddle(game.Opponent, 1);
+            } else if (offset < -kPaddleStep) {
+                Physics::NudgePaddle(game.Opponent, -1);
+            }
+            KeepOnField(game.Opponent);
+        }
+
+        const Scorer scorer = game.Tick();
+        slot.Steps++;
+        const bool outOfSteps = Config.MaxSteps != 0 && slot.Steps >= Config.MaxSteps;
+        slot.NeedsReset       = game.IsOver() || outOfSteps;
+
+        if (scorer == Scorer::Player) {
+            return 1;
+        }
+        if (scorer == Scorer::Opponent) {
+            return -1;
+        }
+        return 0;
+    }
+
+    void WriteObservation(const Slot& slot, float* out) const {
+        const Match& game     = slot.Game;
+        const auto width      = static_cast<float>(Config.Width);
+        const auto height     = static_cast<float>(Config.Height);
+        const auto speed      = static_cast<float>(kInitBallSpeed);
+        const auto scoreLimit = static_cast<float>(Config.ScoreLimit);
+
+        out[PONG_OBS_BALL_X]          = static_cast<float>(game.Ball.Position.X) / width;
+        out[PONG_OBS_BALL_Y]          = static_cast<float>(game.Ball.Position.Y) / height;
+        out[PONG_OBS_BALL_VELOCITY_X] = static_cast<float>(game.Ball.Velocity.X) / speed;
+        out[PONG_OBS_BALL_VELOCITY_Y] = static_cast<float>(game.Ball.Velocity.Y) / speed;
+        out[PONG_OBS_PLAYER_Y]        = static_cast<float>(game.Player.Position.Y) / height;
+        out[PONG_OBS_OPPONENT_Y]      = static_cast<float>(game.Opponent.Position.Y) / height;
+        out[PONG_OBS_PLAYER_SCORE]    = static_cast<float>(game.State.PlayerScore) / scoreLimit;
+        out[PONG_OBS_OPPONENT_SCORE]  = static_cast<float>(game.State.OpponentScore) / scoreLimit;
+    }
+
+    // Fills `rect` (game units) into a PixelWidth x PixelHeight frame
+    void FillRect(const Rect& rect, uint8_t* frame) const {
+        const float scaleX = static_cast<float>(Config.PixelWidth) / Config.Width;
+        const float scaleY = static_cast<float>(Config.PixelHeight) / Config.Height;
+
+        const float x0 = static_cast<float>(rect.Left) * scaleX;
+        const float x1 = static_cast<float>(rect.Right) * scaleX;
+        const float y0 = static_cast<float>(rect.Top) * scaleY;
+        const float y1 = static_cast<float>(rect.Bottom) * scaleY;
+
+        const auto toPixel = [](const float value, const uint32_t limit) {
+            return static_cast<uint32_t>(std::clamp(value, 0.0f, static_cast<float>(limit)));
+        };
+
+        // The far edges round up, so every object covers at least one pixel however far the frame
+        // is scaled down
+        const uint32_t left   = toPixel(x0, Config.PixelWidth);
+        const uint32_t right  = toPixel(x1 + 1, Config.PixelWidth);
+        const uint32_t top    = toPixel(y0, Config.PixelHeight);
+        const uint32_t bottom = toPixel(y1 + 1, Config.PixelHeight);
+
+        for (uint32_t y = top; y < bottom && left < right; ++y) {
+            uint8_t* row = frame + static_cast<size_t>(y) * Config.PixelWidth;
+            std::memset(row + left, 255, right - left);
+        }
+    }
+
+    void WriteFrame(const Slot& slot, uint8_t* frame) const {
+        std::memset(frame, 0, FrameSize);
+        FillRect(Rect::FromCenter(slot.Game.Player.Position, slot.Game.Player.Size), frame);
+        FillRect(Rect::FromCenter(slot.Game.Opponent.Position, slot.Game.Opponent.Size), frame);
+        FillRect(Rect::FromCenter(slot.Game.Ball.Position, slot.Game.Ball.Size), frame);
+    }
+
+    void WriteOutputs(const size_t index, const float reward, const PongEnvBuffers& out) const {
+        const Slot& slot = Slots[index];
+        WriteObservation(slot, out.Observations + index * PONG_OBS_SIZE);
+        if (out.Pixels && FrameSize != 0) {
+            WriteFrame(slot, out.Pixels + index * FrameSize);
+        }
+        if (out.Rewards) {
+            out.Rewards[index] = reward;
+        }
+        if (out.Dones) {
+            out.Dones[index] = slot.NeedsReset ? 1 : 0;
+        }
+    }
+};
+
+// Callers built against an older header pass a shorter config; the fields they don't know about
+// keep their defaults. PixelHeight is the last field of API version 1.
+static constexpr size_t kMinConfigSize = offsetof(PongEnvConfig, PixelHeight) + sizeof(uint32_t);
+
+static bool IsValid(const PongEnvConfig& config) {
+    // Field coordinates have to fit the Q16.16 range with room for the ball to leave the field
+    constexpr int32_t kMaxFieldSize = 16384;
+
+    return config.EnvCount > 0 && config.Width > 200 && config.Width <= kMaxFieldSize &&
+           config.Height > 0 && config.Height <= kMaxFieldSize && config.ScoreLimit > 0 &&
+           (config.PixelWidth == 0) == (config.PixelHeight == 0);
+}
+
+extern "C" {
+
+uint32_t PongEnvApiVersion(void) {
+    return PONG_ENV_API_VERSION;
+}
+
+void PongEnvDefaultConfig(PongEnvConfig* config) {
+    if (!config) {
+        return;
+    }
+
+    *config               = {};
+    config->StructSize    = sizeof(PongEnvConfig);
+    config->EnvCount      = 1;
+    config->Width         = 1920;
+    config->Height        = 1080;
+    config->ScoreLimit    = 10;
+    config->OpponentSkill = 0.8f;
+}
+
+int PongEnvCreate(const PongEnvConfig* config, PongEnv** env) {
+    if (!config || !env || config->StructSize < kMinConfigSize ||
+        config->StructSize > sizeof(PongEnvConfig)) {
+        return PONG_ENV_INVALID_ARGUMENT;
+    }
+
+    PongEnvConfig full;
+    PongEnvDefaultConfig(&full);
+    std::memcpy(&full, config, config->StructSize);
+    full.StructSize = sizeof(PongEnvConfig);
+    if (!IsValid(full)) {
+        return PONG_ENV_INVALID_ARGUMENT;
+    }
+
+    // Exceptions must not cross the C boundary
+    try {
+        *env = new PongEnv(full);
+    } catch (const std::bad_alloc&) {
+        *env = nullptr;
+        return PONG_ENV_OUT_OF_MEMORY;
+    }
+    return PONG_ENV_OK;
+}
+
+void PongEnvDestroy(PongEnv* env) {
+    delete env;
+}
+
+int PongEnvReset(PongEnv* env, const uint64_t seed, const PongEnvBuffers* out) {
+    if (!env || !out || !out->Observations) {
+        return PONG_ENV_INVALID_ARGUMENT;
+    }
+
+    Rng seeder(seed);
+    for (size_t i = 0; i < env->Slots.size(); ++i) {
+        auto& slot      = env->Slots[i];
+        slot.Random     = Rng(seeder.Next());
+        slot.NeedsReset = false;
+        env->StartEpisode(slot);
+        env->WriteOutputs(i, 0, *out);
+    }
+    return PONG_ENV_OK;
+}
+
+int PongEnvStep(PongEnv* env, const int32_t* actions, const PongEnvBuffers* out) {
+    if (!env || !actions || !out || !out->Observations) {
+        return PONG_ENV_INVALID_ARGUMENT;
+    }
+
+    for (size_t i = 0; i < env->Slots.size(); ++i) {
+        auto& slot   = env->Slots[i];
+        float reward = 0;
+        if (slot.NeedsReset) {
+            slot.NeedsReset = false;
+            env->StartEpisode(slot);
+        } else {
+            reward = env->Advance(slot, actions[i]);
+        }
+        env->WriteOutputs(i, reward, *out);
+    }
+    return PONG_ENV_OK;
+}
+
+}  // extern "C"
@@ -0,0 +1,98 @@
+#pragma once
+
+/*
+ * C ABI for stepping many headless matches in lockstep, e.g. as a vectorized environment for
+ * training paddle agents from Python (ctypes/cffi) or any other language with a C FFI.
+ *
+ * Every environment is a Match from Simulation.h, so it runs the game's own fixed-point physics.
+ * The agent plays the left (player) paddle; the right paddle is a scripted opponent that tracks
+ * the ball.
+ *
+ * Nothing is allocated after PongEnvCreate. Reset and Step write straight into the buffers the
+ * caller passes (e.g. numpy arrays), one row per environment.
+ *
+ * Environments that report done are reset by the following Step, which ignores their action and
+ * returns the first observation of the new episode with a reward of 0.
+ *
+ * Seeding is deterministic: the same seed, config and actions give bit-identical output on every
+ * platform. Environment i draws from its own stream derived from (seed, i).
+ */
+#include <stdint.h>
+
+#define PONG_ENV_API_VERSION 1
+
+#if defined(_WIN32)
+    #if defined(PONG_ENV_BUILD)
+        #define PONG_ENV_API __declspec(dllexport)
+    #else
+        #define PONG_ENV_API __declspec(dllimport)
+    #endif
+#else
+    #define PONG_ENV_API __attribute__((visibility("default")))
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Return codes
+#define PONG_ENV_OK               0
+#define PONG_ENV_INVALID_ARGUMENT (-1)
+#define PONG_ENV_OUT_OF_MEMORY    (-2)
+
+// One observation row. Positions are in field sizes (0..1), velocities in serve speeds and scores
+// in fractions of the score limit.
+enum PongEnvObservation {
+    PONG_OBS_BALL_X,
+    PONG_OBS_BALL_Y,
+    PONG_OBS_BALL_VELOCITY_X,
+    PONG_OBS_BALL_VELOCITY_Y,
+    PONG_OBS_PLAYER_Y,
+    PONG_OBS_OPPONENT_Y,
+    PONG_OBS_PLAYER_SCORE,
+    PONG_OBS_OPPONENT_SCORE,
+    PONG_OBS_SIZE
+};
+
+typedef struct PongEnvConfig {
+    uint32_t StructSize;  // sizeof(PongEnvConfig), filled in by PongEnvDefaultConfig. Smaller
+                          // sizes from older headers are accepted; missing fields get defaults.
+    uint32_t EnvCount;    // Number of environments stepped together (default 1)
+    int32_t Width;        // Field size in game units (default 1920 x 1080)
+    int32_t Height;
+    int32_t ScoreLimit;   // Points until the match is over (default 10)
+    uint32_t MaxSteps;    // Steps before an episode is cut short, 0 = no limit (default 0)
+    float OpponentSkill;  // Chance per step that the opponent follows the ball (default 0.8)
+    uint32_t PixelWidth;  // Size of the downsampled grayscale frames, 0 = no frames (default 0)
+    uint32_t PixelHeight;
+} PongEnvConfig;
+
+// Output rows, EnvCount of each
+typedef struct PongEnvBuffers {
+    float* Observations;  // EnvCount * PONG_OBS_SIZE
+    uint8_t* Pixels;      // EnvCount * PixelHeight * PixelWidth, row-major; NULL to skip
+    float* Rewards;       // +1 when the agent scores, -1 when the opponent does; NULL to skip
+    uint8_t* Dones;       // 1 when the match is over or MaxSteps was reached; NULL to skip
+} PongEnvBuffers;
+
+typedef struct PongEnv PongEnv;
+
+// PONG_ENV_API_VERSION of the loaded library
+PONG_ENV_API uint32_t PongEnvApiVersion(void);
+
+PONG_ENV_API void PongEnvDefaultConfig(PongEnvConfig* config);
+
+PONG_ENV_API int PongEnvCreate(const PongEnvConfig* config, PongEnv** env);
+
+PONG_ENV_API void PongEnvDestroy(PongEnv* env);
+
+// Starts a new episode in every environment and writes the first observations
+PONG_ENV_API int PongEnvReset(PongEnv* env, uint64_t seed, const PongEnvBuffers* out);
+
+// Advances every environment by one fixed update. `actions` holds one entry per environment:
+// < 0 moves the agent's paddle up, > 0 moves it down, 0 leaves it.
+PONG_ENV_API int PongEnvStep(PongEnv* env, const int32_t* actions, const PongEnvBuffers* out);
+
+#ifdef __cplusplus
+}
+#endif
@@ -23,12 +23,16 @@
 #include <format>
 
 #include "res/resource.h"
-
-#include <fstream>
+#include "Math.h"
+#include "Simulation.h"
+#include "AssetArchive.h"
+#include "TaskGraph.h"
+#include "Damage.h"
 
 static constexpr bool kDrawBoundingBoxes = false;
+static constexpr int kDamageLogInterval  = 600;  // Frames between render damage reports
 
-static float g_InitBallSpeed = 10.f;
+static Scalar g_InitBallSpeed = kInitBallSpeed;
 static bool g_IsRunning      = false;
 static HWND g_Hwnd;
 
@@ -83,55 +87,18 @@ static RECT GetWindowRect(HWND hwnd) {
         }                                                                                          \
     }
 
-struct Vector2 {
-    float X = 0;
-    float Y = 0;
-
-    Vector2 operator-() const {
-        return {-X, -Y};
-    }
-
-    Vector2 operator*(const Vector2& rhs) const {
-        return {X * rhs.X, Y * rhs.Y};
-    }
-
-    Vector2 operator*(const float scalar) const {
-        return {X * scalar, Y * scalar};
-    }
-
-    static float Dot(const Vector2& lhs, const Vector2& rhs) {
-        return lhs.X * rhs.X + lhs.Y * rhs.Y;
-    }
-
-    static Vector2 Reflect(const Vector2& velocity, const Vector2& normal) {
-        const float dotProduct = Dot(velocity, normal);
-        Vector2 reflection;
-        reflection.X = velocity.X - 2 * dotProduct * normal.X;
-        reflection.Y = velocity.Y - 2 * dotProduct * normal.Y;
-        return reflection;
-    }
-
-    [[nodiscard]] D2D1_POINT_2F GetPoint() const {
-        return D2D1::Point2F(X, Y);
-    }
-};
-
-struct GameState {
-    int PlayerScore   = 0;
-    int OpponentScore = 0;
-    int ScoreLimit    = 0;
-
-    [[nodiscard]] int TotalScore() const {
-        return PlayerScore + OpponentScore;
-    }
+template<typename T>
+static D2D1_POINT_2F ToPoint(const BasicVector2<T>& vector) {
+    return D2D1::Point2F(SCAST<float>(vector.X), SCAST<float>(vector.Y));
+}
 
-    void Reset(const int scoreLimit) {
-        PlayerScore   = 0;
-        PlayerScore   = 0;
-        OpponentScore = 0;
-        ScoreLimit    = scoreLimit;
-    }
-};
+template<typename T>
+static D2D1_RECT_F ToRectF(const BasicRect<T>& rect) {
+    return D2D1::RectF(SCAST<float>(rect.Left),
+                       SCAST<float>(rect.Top),
+                       SCAST<float>(rect.Right),
+                       SCAST<float>(rect.Bottom));
+}
 
 struct KeyState {
     bool Pressed  = false;
@@ -161,13 +128,11 @@ struct InputListener {
     virtual void OnMouseUp(MouseEvent event) {}
 };
 
-struct GameObject {
-    D2D1_RECT_F BoundingBox = {};
-    D2D1_COLOR_F Color      = {};
-    Vector2 Position        = {};
-    Vector2 Rotation        = {};
-    Vector2 Size            = {};
-    Vector2 Velocity        = {};
+struct GameObject : Body {
+    D2D1_COLOR_F Color = {};
+    Vector2 Rotation   = {};
+    Rect Painted       = {};    // Area covered by the last frame; Draw paints inside it
+    bool NeedsRepaint  = true;  // Content changed without the area moving
 
     virtual void Start()                               = 0;
     virtual void Update(double dT)                     = 0;
@@ -177,14 +142,23 @@ struct GameObject {
     virtual void Reset() {};
     virtual void FixedUpdate() {};
 
-    void UpdateBoundingBox() {
-        const auto top    = Position.Y - Size.Y;
-        const auto bottom = Position.Y + Size.Y;
-        const auto left   = Position.X - Size.X;
-        const auto right  = Position.X + Size.X;
+    // Area the next Draw will cover
+    [[nodiscard]] virtual Rect PaintBounds() const {
+        return BoundingBox;
+    }
+
+    // Takes a snapshot of the paint bounds for this frame and damages whatever changed since the
+    // last one. Draw uses the snapshot, so it never paints outside the damage even if the update
+    // threads move the object in between.
+    void CollectDamage(DamageRegion& damage) {
+        const Rect bounds = PaintBounds();
+        if (NeedsRepaint) {
+            damage.Add(ToPixelRect(Painted));
+        }
+        damage.AddMove(Painted, bounds);
 
-        const auto boundingBox = D2D1::RectF(left, top, right, bottom);
-        BoundingBox            = boundingBox;
+        Painted      = bounds;
+        NeedsRepaint = false;
     }
 
     void DrawBoundingBox(ID2D1RenderTarget* renderTarget) const {
@@ -193,14 +167,14 @@ struct GameObject {
           renderTarget->CreateSolidColorBrush(D2D1::ColorF(D2D1::ColorF::Red), &boundsBrush);
         CATCH_COM_EXCEPTION;
 
-        renderTarget->DrawRectangle(BoundingBox, boundsBrush, 1);
+        renderTarget->DrawRectangle(ToRectF(BoundingBox), boundsBrush, 1);
         boundsBrush->Release();
     }
 };
 
 struct WAVFile {
     WAVEFORMATEX Format;
-    std::vector<BYTE> Data;
+    std::span<const BYTE> Data;  // Points into the asset archive mapping
 };
 
 static GameState g_GameState = {.ScoreLimit = 10};
@@ -212,6 +186,8 @@ static std::vector<InputListener*> g_InputListeners;
 static std::unordered_map<int, KeyState> g_KeyStates;
 static IXAudio2* g_XAudio2;
 static IXAudio2MasteringVoice* g_MasterVoice;
+static AssetArchive g_Assets;
+static DamageRegion g_Damage;
 
 std::thread g_InputDispatcherThread;
 std::thread g_FixedUpdateThread;
@@ -234,58 +210,50 @@ inline void ANSIToWide(const std::string& value, std::wstring& converted) {
     converted = converter.from_bytes(value);
 }
 
-bool Overlaps(const D2D1_RECT_F& rectA, const D2D1_RECT_F& rectB) {
-    if (rectA.right <= rectB.left || rectB.right <= rectA.left) {
-        return false;
-    }
-
-    if (rectA.bottom <= rectB.top || rectB.bottom <= rectA.top) {
-        return false;
-    }
-
-    return true;
+template<typename T>
+static T ReadAt(const std::span<const BYTE> bytes, const size_t offset) {
+    T value;
+    memcpy(&value, bytes.data() + offset, sizeof(T));
+    return value;
 }
 
-bool LoadWAVFile(const char* filename, WAVFile& wavFile) {
-    std::ifstream file(filename, std::ios::binary);
-    if (!file.is_open())
+bool LoadWAVFile(const AssetId id, WAVFile& wavFile) {
+    const auto asset = g_Assets.Get(id);
+    if (!asset)
         return false;
 
-    // Read header
-    file.seekg(0, std::ios::end);
-    size_t fileSize = file.tellg();
-    file.seekg(0, std::ios::beg);
-
-    BYTE header[44];
-    file.read(reinterpret_cast<char*>(header), 44);
+    constexpr size_t headerSize = 44;
+    const auto bytes            = *asset;
+    if (bytes.size() < headerSize)
+        return false;
 
     // Parse header (assuming it's a valid WAV file)
-    wavFile.Format.wFormatTag      = *reinterpret_cast<WORD*>(&header[20]);
-    wavFile.Format.nChannels       = *reinterpret_cast<WORD*>(&header[22]);
-    wavFile.Format.nSamplesPerSec  = *reinterpret_cast<DWORD*>(&header[24]);
-    wavFile.Format.nAvgBytesPerSec = *reinterpret_cast<DWORD*>(&header[28]);
-    wavFile.Format.nBlockAlign     = *reinterpret_cast<WORD*>(&header[32]);
-    wavFile.Format.wBitsPerSample  = *reinterpret_cast<WORD*>(&header[34]);
+    wavFile.Format.wFormatTag      = ReadAt<WORD>(bytes, 20);
+    wavFile.Format.nChannels       = ReadAt<WORD>(bytes, 22);
+    wavFile.Format.nSamplesPerSec  = ReadAt<DWORD>(bytes, 24);
+    wavFile.Format.nAvgBytesPerSec = ReadAt<DWORD>(bytes, 28);
+    wavFile.Format.nBlockAlign     = ReadAt<WORD>(bytes, 32);
+    wavFile.Format.wBitsPerSample  = ReadAt<WORD>(bytes, 34);
     wavFile.Format.cbSize          = 0;
 
-    const size_t dataSize = *reinterpret_cast<DWORD*>(&header[40]);
-    wavFile.Data.resize(dataSize);
-    file.read(reinterpret_cast<char*>(wavFile.Data.data()), SCAST<std::streamsize>(dataSize));
+    const size_t dataSize = ReadAt<DWORD>(bytes, 40);
+    if (dataSize > bytes.size() - headerSize)
+        return false;
+
+    wavFile.Data = bytes.subspan(headerSize, dataSize);
 
     return true;
 }
 
-void PlayOneShot(const char* wavFile) {
+// Throws on failure, so it can run on any thread; the caller decides how to report it
+void PlayOneShot(const AssetId wavFile) {
     WAVFile wav = {};
     if (!LoadWAVFile(wavFile, wav)) {
-        MessageBoxA(g_Hwnd, "Failed to load wav file", "Runtime Error", MB_OK | MB_ICONWARNING);
-        return;
+        throw AssetError("Failed to load wav file");
     }
 
     IXAudio2SourceVoice* pSourceVoice = nullptr;
-
-    auto hr = g_XAudio2->CreateSourceVoice(&pSourceVoice, &wav.Format);
-    CATCH_COM_EXCEPTION;
+    CheckResult(g_XAudio2->CreateSourceVoice(&pSourceVoice, &wav.Format));
 
     // Submit audio buffer
     XAUDIO2_BUFFER buffer = {0};
@@ -293,12 +261,15 @@ void PlayOneShot(const char* wavFile) {
     buffer.pAudioData     = wav.Data.data();
     buffer.Flags          = XAUDIO2_END_OF_STREAM;
 
-    hr = pSourceVoice->SubmitSourceBuffer(&buffer);
-    CATCH_COM_EXCEPTION;
+    try {
+        CheckResult(pSourceVoice->SubmitSourceBuffer(&buffer));
 
-    // Start playing
-    hr = pSourceVoice->Start(0);
-    CATCH_COM_EXCEPTION;
+        // Start playing
+        CheckResult(pSourceVoice->Start(0));
+    } catch (...) {
+        pSourceVoice->DestroyVoice();
+        throw;
+    }
 }
 
 /*
@@ -312,44 +283,27 @@ struct Ball final : GameObject {
         GameObject::Reset();
         m_Speed = g_InitBallSpeed;
 
-        if (m_LastToScore == 1) {
-            // TODO: Randomize Y velocity
-            Velocity = {m_Speed, 0.f};
-        } else {
-            Velocity = {-m_Speed, 0.f};
-        }
-        Position = {windowRect.right / 2.f, windowRect.bottom / 2.f};
+        Velocity = Physics::ServeVelocity(m_LastToScore, m_Speed);
+        Position = {Scalar(windowRect.right) / 2, Scalar(windowRect.bottom) / 2};
     }
 
     void Move() {
-        Position.X += Velocity.X;
-        Position.Y += Velocity.Y;
+        Physics::Move(*this);
     }
 
     void CheckCollision() {
         const auto paddlePlayer   = g_GameObjects["Player"];
         const auto paddleOpponent = g_GameObjects["Opponent"];
 
-        // TODO: Implement calculations for reflecting ball off paddle correctly
-        if (Overlaps(BoundingBox, paddlePlayer->BoundingBox) ||
-            Overlaps(BoundingBox, paddleOpponent->BoundingBox)) {
-            Velocity = -Velocity;
-            // increase ball speed
-            Velocity.X *= 1.05;
-            Velocity.Y *= 1.05;
-        }
+        Physics::CollideBall(*this, *paddlePlayer, *paddleOpponent);
     }
 
     void CheckOOB(const RECT& windowRect) {
-        if (Position.X < 0.0) {
+        const auto scorer = Physics::CheckOOB(*this, Scalar(windowRect.right));
+        if (scorer != Scorer::None) {
             // Score and reset ball
-            g_GameState.OpponentScore++;
-            m_LastToScore = 0;
-            Reset(windowRect);
-        } else if (Position.X > SCAST<float>(windowRect.right)) {
-            // Score opponent and reset ball
-            g_GameState.PlayerScore++;
-            m_LastToScore = 1;
+            g_GameState.AddPoint(scorer);
+            m_LastToScore = scorer;
             Reset(windowRect);
         }
     }
@@ -367,18 +321,30 @@ struct Ball final : GameObject {
 
     void Update(const double dT) override {}
 
+    // The bounding box lags a fixed update behind, so go by the position instead
+    [[nodiscard]] Rect PaintBounds() const override {
+        return Rect::FromCenter(Position, Size);
+    }
+
     void Draw(ID2D1RenderTarget* renderTarget) override {
         ID2D1SolidColorBrush* brush = nullptr;
         const auto hr               = renderTarget->CreateSolidColorBrush(Color, &brush);
         CATCH_COM_EXCEPTION;
 
-        renderTarget->FillEllipse(D2D1::Ellipse(Position.GetPoint(), Size.X, Size.Y), brush);
+        const auto bounds = ToRectF(Painted);
+        const auto radius = D2D1::SizeF((bounds.right - bounds.left) / 2,
+                                        (bounds.bottom - bounds.top) / 2);
+        renderTarget->FillEllipse(
+          D2D1::Ellipse(D2D1::Point2F(bounds.left + radius.width, bounds.top + radius.height),
+                        radius.width,
+                        radius.height),
+          brush);
         brush->Release();
     }
 
 private:
-    int m_LastToScore = 0;
-    float m_Speed     = g_InitBallSpeed;
+    Scorer m_LastToScore = Scorer::None;
+    Scalar m_Speed       = g_InitBallSpeed;
 };
 
 struct Paddle final : GameObject,
@@ -405,18 +371,16 @@ struct Paddle final : GameObject,
         const auto hr               = renderTarget->CreateSolidColorBrush(Color, &brush);
         CATCH_COM_EXCEPTION;
 
-        renderTarget->FillRectangle(BoundingBox, brush);
+        renderTarget->FillRectangle(ToRectF(Painted), brush);
         brush->Release();
     }
 
     void OnKey(const KeyEvent event) override {
         // TODO: Bug where arrow key and alpha key pressed together double paddle speed
         if (event.KeyCode == VK_UP || event.KeyCode == 'W') {
-            Position.Y -= 10.f;
-            Velocity.Y = -100.f;
+            Physics::NudgePaddle(*this, -1);
         } else if (event.KeyCode == VK_DOWN || event.KeyCode == 'S') {
-            Position.Y += 10.f;
-            Velocity.Y = 100.f;
+            Physics::NudgePaddle(*this, 1);
         }
     }
 
@@ -425,39 +389,46 @@ private:
 };
 
 struct GameText final : GameObject {
+    // Runs in the pool's "Start" stage, so failures throw for WinMain to report
     void Start() override {
-        auto hr = g_DWriteFactory->CreateTextFormat(L"Unispace",
-                                                    nullptr,
-                                                    DWRITE_FONT_WEIGHT_BOLD,
-                                                    DWRITE_FONT_STYLE_NORMAL,
-                                                    DWRITE_FONT_STRETCH_NORMAL,
-                                                    40.f,
-                                                    L"en-us",
-                                                    &m_TextFormat);
-        CATCH_COM_EXCEPTION;
-
-        hr = m_TextFormat->SetTextAlignment(DWRITE_TEXT_ALIGNMENT_CENTER);
-        CATCH_COM_EXCEPTION;
-
-        hr = m_TextFormat->SetParagraphAlignment(DWRITE_PARAGRAPH_ALIGNMENT_CENTER);
-        CATCH_COM_EXCEPTION;
+        CheckResult(g_DWriteFactory->CreateTextFormat(L"Unispace",
+                                                      nullptr,
+                                                      DWRITE_FONT_WEIGHT_BOLD,
+                                                      DWRITE_FONT_STYLE_NORMAL,
+                                                      DWRITE_FONT_STRETCH_NORMAL,
+                                                      40.f,
+                                                      L"en-us",
+                                                      &m_TextFormat));
+        CheckResult(m_TextFormat->SetTextAlignment(DWRITE_TEXT_ALIGNMENT_CENTER));
+        CheckResult(m_TextFormat->SetParagraphAlignment(DWRITE_PARAGRAPH_ALIGNMENT_CENTER));
     }
 
     void Update(double dT) override {
         const auto fmt = std::format("{} | {}", g_GameState.PlayerScore, g_GameState.OpponentScore);
-        ANSIToWide(fmt, m_Text);
+        std::wstring text;
+        ANSIToWide(fmt, text);
+        if (text != m_Text) {
+            m_Text       = std::move(text);
+            NeedsRepaint = true;
+        }
         UpdateBoundingBox();
     }
 
+    // The text is centered in the layout box, so all of it may change
+    [[nodiscard]] Rect PaintBounds() const override {
+        return {0, 0, Position.X, Position.Y};
+    }
+
     void Draw(ID2D1RenderTarget* renderTarget) override {
         ID2D1SolidColorBrush* brush = nullptr;
         const auto hr               = renderTarget->CreateSolidColorBrush(Color, &brush);
         CATCH_COM_EXCEPTION;
 
+        const auto layoutRect = ToRectF(Painted);
         renderTarget->DrawTextA(m_Text.c_str(),
                                 wcslen(m_Text.c_str()),
                                 m_TextFormat,
-                                D2D1::RectF(0, 0, Position.X, Position.Y),
+                                layoutRect,
                                 brush);
     }
 
@@ -487,60 +458,81 @@ void InputDispatcher() {
     }
 }
 
-void Initialize() {
-    auto hr = D2D1CreateFactory(D2D1_FACTORY_TYPE_SINGLE_THREADED, &g_Factory);
-    CATCH_COM_EXCEPTION;
+void Start();
 
-    RECT rc;
-    GetClientRect(g_Hwnd, &rc);
-    hr = g_Factory->CreateHwndRenderTarget(
-      D2D1::RenderTargetProperties(),
-      D2D1::HwndRenderTargetProperties(g_Hwnd, D2D1::SizeU(rc.right - rc.left, rc.bottom - rc.top)),
-      &g_RenderTarget);
-    CATCH_COM_EXCEPTION;
-
-    hr = DWriteCreateFactory(DWRITE_FACTORY_TYPE_SHARED,
-                             __uuidof(IDWriteFactory),
-                             RCAST<IUnknown**>(&g_DWriteFactory));
-    CATCH_COM_EXCEPTION;
-
-    // Load UI font
-    {}
-
-    // Initialize XAudio2
-    {
-        hr = XAudio2Create(&g_XAudio2, 0, XAUDIO2_DEFAULT_PROCESSOR);
-        CATCH_COM_EXCEPTION;
+void LogStage(const StageTiming& stage) {
+    const auto fmt = std::format("[Startup] {:<12} {:8.2f} ms -> {:8.2f} ms ({:.2f} ms)\n",
+                                 stage.Name,
+                                 stage.StartMs,
+                                 stage.EndMs,
+                                 stage.EndMs - stage.StartMs);
+    ::OutputDebugStringA(fmt.c_str());
+}
 
-        hr = g_XAudio2->CreateMasteringVoice(&g_MasterVoice);
-        CATCH_COM_EXCEPTION;
-    }
+struct StartupTasks {
+    TaskGraph::Task FirstFrame;  // Everything the first frame needs
+    TaskGraph::Task Music;       // Not needed for the first frame; checked once it is done
+};
 
-    g_InputDispatcherThread = std::thread(InputDispatcher);
-    g_FixedUpdateThread     = std::thread(FixedUpdate);
+// Builds the startup graph. Stages report failures by throwing; TaskGraph::Wait rethrows them on
+// the main thread.
+StartupTasks Initialize(TaskGraph& startup) {
+    using Affinity = TaskGraph::Affinity;
 
-    {
-        // Initialize the game objects
+    RECT rc;
+    GetClientRect(g_Hwnd, &rc);
+
+    const auto assets = startup.Add("Assets", {}, [] { g_Assets.Open("assets.pak"); });
+
+    // The render target belongs to the window, so it is created on the window's thread
+    const auto direct2D = startup.Add(
+      "Direct2D",
+      {},
+      [rc] {
+          CheckResult(D2D1CreateFactory(D2D1_FACTORY_TYPE_SINGLE_THREADED, &g_Factory));
+
+          const auto size = D2D1::SizeU(rc.right - rc.left, rc.bottom - rc.top);
+          // Frames only repaint what changed, so the back buffer has to survive presenting
+          const auto hwndProperties = D2D1::HwndRenderTargetProperties(
+            g_Hwnd, size, D2D1_PRESENT_OPTIONS_RETAIN_CONTENTS);
+          CheckResult(g_Factory->CreateHwndRenderTarget(D2D1::RenderTargetProperties(),
+                                                        hwndProperties,
+                                                        &g_RenderTarget));
+      },
+      Affinity::MainThread);
+
+    const auto directWrite = startup.Add("DirectWrite", {}, [] {
+        CheckResult(DWriteCreateFactory(DWRITE_FACTORY_TYPE_SHARED,
+                                        __uuidof(IDWriteFactory),
+                                        RCAST<IUnknown**>(&g_DWriteFactory)));
+
+        // Load UI font
+        {}
+    });
+
+    const auto xaudio2 = startup.Add("XAudio2", {}, [] {
+        CheckResult(XAudio2Create(&g_XAudio2, 0, XAUDIO2_DEFAULT_PROCESSOR));
+        CheckResult(g_XAudio2->CreateMasteringVoice(&g_MasterVoice));
+    });
+
+    const auto objects = startup.Add("GameObjects", {}, [rc] {
         const auto ball = new Ball;
         ball->Color     = D2D1::ColorF(D2D1::ColorF::White);
-        ball->Position  = {SCAST<float>(rc.right - rc.left) / 2,
-                           SCAST<float>(rc.bottom - rc.top) / 2};
+        ball->Position  = {Scalar(rc.right - rc.left) / 2, Scalar(rc.bottom - rc.top) / 2};
         ball->Size      = {16, 16};
 
         const auto paddlePlayer = new Paddle(false);
         paddlePlayer->Color     = D2D1::ColorF(D2D1::ColorF::CornflowerBlue);
-        paddlePlayer->Position  = {SCAST<float>(rc.left) + 100,
-                                   SCAST<float>(rc.bottom - rc.top) / 2};
+        paddlePlayer->Position  = {Scalar(rc.left) + 100, Scalar(rc.bottom - rc.top) / 2};
         paddlePlayer->Size      = {16, 100};
 
         const auto paddleOpponent = new Paddle(true);
         paddleOpponent->Color     = D2D1::ColorF(0xED64A6);
-        paddleOpponent->Position  = {SCAST<float>(rc.right) - 100,
-                                     SCAST<float>(rc.bottom - rc.top) / 2};
+        paddleOpponent->Position  = {Scalar(rc.right) - 100, Scalar(rc.bottom - rc.top) / 2};
         paddleOpponent->Size      = {16, 100};
 
         const auto gameText = new GameText;
-        gameText->Position  = {SCAST<float>(rc.right), 140.f};
+        gameText->Position  = {Scalar(rc.right), 140};
         gameText->Size      = {32, 0};  // 16pt font, Y value not needed
         gameText->Color     = D2D1::ColorF(D2D1::ColorF::White);
 
@@ -549,7 +541,24 @@ void Initialize() {
         g_GameObjects["Opponent"] = paddleOpponent;
         g_GameObjects["Ball"]     = ball;
         g_GameObjects["GameText"] = gameText;
-    }
+    });
+
+    // GameText::Start needs the DirectWrite factory
+    const auto started = startup.Add("Start", {objects, directWrite}, Start);
+
+    // The first frame doesn't need music; the main loop reports a failure once the stage is done
+    const auto music =
+      startup.Add("Music", {assets, xaudio2}, [] { PlayOneShot(AssetIdOf("bg_music.wav")); });
+
+    // The update threads are only launched once everything else the first frame needs is up, so a
+    // failed stage never leaves them running behind the early return in WinMain
+    const auto simulation = startup.Add("Simulation", {started, assets, direct2D}, [] {
+        g_IsRunning             = true;
+        g_InputDispatcherThread = std::thread(InputDispatcher);
+        g_FixedUpdateThread     = std::thread(FixedUpdate);
+    });
+
+    return {startup.Add("FirstFrame", {simulation}, [] {}), music};
 }
 
 void Reset() {
@@ -570,8 +579,19 @@ void Shutdown() {
         g_Factory = nullptr;
     }
 
-    g_MasterVoice->DestroyVoice();
-    g_XAudio2->Release();
+    // Audio is optional: either may be missing if the XAudio2 stage failed
+    if (g_MasterVoice) {
+        g_MasterVoice->DestroyVoice();
+        g_MasterVoice = nullptr;
+    }
+
+    if (g_XAudio2) {
+        g_XAudio2->Release();
+        g_XAudio2 = nullptr;
+    }
+
+    // Voices may still be reading from the mapping until XAudio2 is released
+    g_Assets.Close();
 
     g_InputDispatcherThread.join();
     g_FixedUpdateThread.join();
@@ -581,8 +601,6 @@ void Start() {
     for (const auto& go : g_GameObjects | Map::Values) {
         go->Start();
     }
-
-    PlayOneShot("assets/bg_music.wav");
 }
 
 void FixedUpdate() {
@@ -617,26 +635,83 @@ void Update(const double dT) {
     }
 }
 
+// Draws every object that reaches into `area`. The caller has clipped to it.
+void DrawObjects(const Rect& area) {
+    for (const auto& go : g_GameObjects | Map::Values) {
+        if (!Overlaps(go->Painted, area)) {
+            continue;
+        }
+
+        go->Draw(g_RenderTarget);
+
+        if constexpr (kDrawBoundingBoxes) {
+            go->DrawBoundingBox(g_RenderTarget);
+        }
+    }
+}
+
+// Reports the average fill per frame, to compare against full redraws
+void LogDamage() {
+    static int64_t pixelsTouched = 0;
+    static int fullRedraws       = 0;
+    static int frames            = 0;
+
+    pixelsTouched += g_Damage.PixelsTouched();
+    fullRedraws += g_Damage.IsFullRedraw() ? 1 : 0;
+    if (++frames < kDamageLogInterval) {
+        return;
+    }
+
+    const auto perFrame = SCAST<double>(pixelsTouched) / frames;
+    const auto coverage = 100.0 * perFrame / SCAST<double>(Area(g_Damage.Surface()));
+    const auto fmt      = std::format("[Render] {:.0f} px/frame ({:.1f}% of full), {} full\n",
+                                     perFrame,
+                                     coverage,
+                                     fullRedraws);
+    ::OutputDebugStringA(fmt.c_str());
+
+    pixelsTouched = 0;
+    fullRedraws   = 0;
+    frames        = 0;
+}
+
 void Frame() {
     if (g_RenderTarget) {
-        g_RenderTarget->BeginDraw();
-        g_RenderTarget->Clear(D2D1::ColorF(0x11121C));
+        if constexpr (kDrawBoundingBoxes) {
+            g_Damage.InvalidateAll();  // Outlines are drawn over neighbours; don't track them
+        }
 
-        // Draw game stuff here
+        const auto size = g_RenderTarget->GetSize();
+        g_Damage.Begin(SCAST<int>(std::ceil(size.width)), SCAST<int>(std::ceil(size.height)));
         for (const auto& go : g_GameObjects | Map::Values) {
-            go->Draw(g_RenderTarget);
+            go->CollectDamage(g_Damage);
+        }
 
-            if constexpr (kDrawBoundingBoxes) {
-                go->DrawBoundingBox(g_RenderTarget);
+        const auto background = D2D1::ColorF(0x11121C);
+        g_RenderTarget->BeginDraw();
+
+        if (g_Damage.IsFullRedraw()) {
+            g_RenderTarget->Clear(background);
+            DrawObjects(ToRect(g_Damage.Surface()));
+        } else {
+            // Clear honours the clip, so each damaged rect is wiped and repainted on its own
+            for (const auto& damaged : g_Damage.Rects()) {
+                g_RenderTarget->PushAxisAlignedClip(ToRectF(damaged), D2D1_ANTIALIAS_MODE_ALIASED);
+                g_RenderTarget->Clear(background);
+                DrawObjects(ToRect(damaged));
+                g_RenderTarget->PopAxisAlignedClip();
             }
         }
 
         const auto hr = g_RenderTarget->EndDraw();
         CATCH_COM_EXCEPTION;
+
+        LogDamage();
     }
 }
 
 void OnResize(const int w, const int h) {
+    g_Damage.InvalidateAll();
     if (g_RenderTarget) {
         const auto hr = g_RenderTarget->Resize(D2D1::SizeU(w, h));
         CATCH_COM_EXCEPTION;
@@ -676,6 +751,10 @@ LRESULT CALLBACK WndProc(HWND hwnd, UINT uMsg, WPARAM wParam, LPARAM lParam) {
         case WM_DESTROY:
             ::PostQuitMessage(0);
             return 0;
+        case WM_PAINT:
+            // Uncovered or restored: repaint everything on the next frame
+            g_Damage.InvalidateAll();
+            break;
         case WM_SIZE: {
             auto [left, top, right, bottom] = GetWindowRect(hwnd);
             const auto w                    = right - left;
@@ -770,13 +849,28 @@ int WINAPI WinMain(HINSTANCE hInstance, HINSTANCE hPrevInstance, LPSTR lpCmdLine
     ::ShowWindow(g_Hwnd, nCmdShow);
     ::UpdateWindow(g_Hwnd);
 
-    Initialize();
+    // Worker threads talk to COM (DirectWrite, XAudio2)
+    const auto workerCount = std::thread::hardware_concurrency();
+    ThreadPool startupPool(workerCount > 2 ? workerCount : 2,
+                           [] { ::CoInitializeEx(nullptr, COINIT_MULTITHREADED); });
+    TaskGraph startup(startupPool);
+    startup.OnStageComplete = LogStage;
+
+    const auto tasks = Initialize(startup);
+    startup.Run();
+
+    try {
+        startup.Wait(tasks.FirstFrame);
+    } catch (std::exception& err) {
+        MessageBoxA(g_Hwnd, err.what(), "Startup Error", MB_OK | MB_ICONERROR);
+        return 1;
+    }
 
     // Enter the main loop
-    MSG msg     = {};
-    g_IsRunning = true;
+    MSG msg             = {};
+    bool presentedFirst = false;
+    bool musicChecked   = false;
     Timer::StartTimer();
-    Start();
 
     constexpr int FPS        = 60;
     constexpr int frameDelay = 1000 / FPS;
@@ -795,6 +889,23 @@ int WINAPI WinMain(HINSTANCE hInstance, HINSTANCE hPrevInstance, LPSTR lpCmdLine
 
         Frame();
 
+        if (!presentedFirst) {
+            presentedFirst = true;
+            const auto fmt = std::format("[Startup] First frame presented at {:.2f} ms\n",
+                                         startup.ElapsedMs());
+            ::OutputDebugStringA(fmt.c_str());
+        }
+
+        // A failed Music stage is only worth a warning, shown from this thread
+        if (!musicChecked && tasks.Music.IsReady()) {
+            musicChecked = true;
+            try {
+                startup.Wait(tasks.Music);
+            } catch (std::exception& err) {
+                MessageBoxA(g_Hwnd, err.what(), "Audio Error", MB_OK | MB_ICONWARNING);
+            }
+        }
+
         auto frameEnd = std::chrono::high_resolution_clock::now();
         std::chrono::duration<float, std::milli> frameDuration = frameEnd - frameStart;
         const auto fps                                         = 1000.f / frameDuration.count();
@@ -803,6 +914,7 @@ int WINAPI WinMain(HINSTANCE hInstance, HINSTANCE hPrevInstance, LPSTR lpCmdLine
     }
 
     g_IsRunning = false;
+    startup.WaitAll();
     Shutdown();
 
     return SCAST<int>(msg.wParam);
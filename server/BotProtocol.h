@@ -0,0 +1,110 @@
+#pragma once
+
+/*
+ * Wire protocol between the bot match server and remote bots. Runs over a stream socket (TCP or
+ * Unix). Every message is a one byte type followed by a fixed-size little-endian payload.
+ *
+ * bot -> server
+ *   'J'                  Join the queue. Bots are paired into matches in arrival order.
+ *   'I' u32 tick, i8 move Paddle input for the state `tick` the bot last saw. move < 0 is up,
+ *                        move > 0 is down, 0 stops. The last input holds until the next one.
+ *
+ * server -> bot
+ *   'W' u32 match, u8 side
+ *                        Matched. Side 0 is the left (player) paddle, 1 the right (opponent).
+ *   'S' u32 tick, i32 ball x, i32 ball y, i32 ball vx, i32 ball vy, i32 own y, i32 other y,
+ *       u8 own score, u8 other score
+ *                        State after `tick`. Positions are raw Q16.16 values.
+ *   'E' u8 result        Match over: 0 lost, 1 won, 2 tie, 3 opponent left. The bot is queued
+ *                        again automatically.
+ */
+#include "../Simulation.h"
+#include "Net.h"
+
+#include <type_traits>
+
+static_assert(std::is_same_v<Scalar, Fixed>, "the bot protocol carries raw Q16.16 values");
+
+namespace BotProtocol {
+    static constexpr uint8_t kJoin    = 'J';
+    static constexpr uint8_t kInput   = 'I';
+    static constexpr uint8_t kWelcome = 'W';
+    static constexpr uint8_t kState   = 'S';
+    static constexpr uint8_t kEnd     = 'E';
+
+    static constexpr size_t kJoinSize    = 1;
+    static constexpr size_t kInputSize   = 1 + 4 + 1;
+    static constexpr size_t kWelcomeSize = 1 + 4 + 1;
+    static constexpr size_t kStateSize   = 1 + 4 + 6 * 4 + 1 + 1;
+    static constexpr size_t kEndSize     = 1 + 1;
+
+    enum class Result : uint8_t { Lost, Won, Tie, OpponentLeft };
+
+    struct State {
+        uint32_t Tick         = 0;
+        int32_t BallX         = 0;
+        int32_t BallY         = 0;
+        int32_t BallVelocityX = 0;
+        int32_t BallVelocityY = 0;
+        int32_t OwnY          = 0;
+        int32_t OtherY        = 0;
+        uint8_t OwnScore      = 0;
+        uint8_t OtherScore    = 0;
+    };
+
+    // Size of a message with the given type, or 0 if the type is unknown
+    inline size_t MessageSize(const uint8_t type) {
+        switch (type) {
+            case kJoin:
+                return kJoinSize;
+            case kInput:
+                return kInputSize;
+            case kWelcome:
+                return kWelcomeSize;
+            case kState:
+                return kStateSize;
+            case kEnd:
+                return kEndSize;
+            default:
+                return 0;
+        }
+    }
+
+    inline void EncodeState(const Match& match, const uint32_t tick, const int side, uint8_t* out) {
+        const Body& own      = side == 0 ? match.Player : match.Opponent;
+        const Body& other    = side == 0 ? match.Opponent : match.Player;
+        const int ownScore   = side == 0 ? match.State.PlayerScore : match.State.OpponentScore;
+        const int otherScore = side == 0 ? match.State.OpponentScore : match.State.PlayerScore;
+
+        out[0] = kState;
+        Net::PutU32(out + 1, tick);
+        Net::PutU32(out + 5, static_cast<uint32_t>(match.Ball.Position.X.Raw));
+        Net::PutU32(out + 9, static_cast<uint32_t>(match.Ball.Position.Y.Raw));
+        Net::PutU32(out + 13, static_cast<uint32_t>(match.Ball.Velocity.X.Raw));
+        Net::PutU32(out + 17, static_cast<uint32_t>(match.Ball.Velocity.Y.Raw));
+        Net::PutU32(out + 21, static_cast<uint32_t>(own.Position.Y.Raw));
+        Net::PutU32(out + 25, static_cast<uint32_t>(other.Position.Y.Raw));
+        out[29] = static_cast<uint8_t>(ownScore);
+        out[30] = static_cast<uint8_t>(otherScore);
+    }
+
+    inline State DecodeState(const uint8_t* in) {
+        State state;
+        state.Tick          = Net::GetU32(in + 1);
+        state.BallX         = static_cast<int32_t>(Net::GetU32(in + 5));
+        state.BallY         = static_cast<int32_t>(Net::GetU32(in + 9));
+        state.BallVelocityX = static_cast<int32_t>(Net::GetU32(in + 13));
+        state.BallVelocityY = static_cast<int32_t>(Net::GetU32(in + 17));
+        state.OwnY          = static_cast<int32_t>(Net::GetU32(in + 21));
+        state.OtherY        = static_cast<int32_t>(Net::GetU32(in + 25));
+        state.OwnScore      = in[29];
+        state.OtherScore    = in[30];
+        return state;
+    }
+
+    inline void EncodeInput(const uint32_t tick, const int8_t move, uint8_t* out) {
+        out[0] = kInput;
+        Net::PutU32(out + 1, tick);
+        out[5] = static_cast<uint8_t>(move);
+    }
+}  // namespace BotProtocol
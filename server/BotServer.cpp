@@ -0,0 +1,866 @@
+/*
+ * Bot match server.
+ *
+ * Hosts many headless matches at once; both paddles of every match are driven by remote bots
+ * speaking BotProtocol.h over TCP or a Unix socket. Bots are paired in arrival order and go back
+ * into the queue when their match ends.
+ *
+ * The main thread only accepts connections and hands them out round-robin to shards. Each shard
+ * is a long-lived job on the thread pool with its own epoll loop and owns its bots and matches
+ * outright, so nothing is shared between shards. Every match keeps its own tick deadline (set when
+ * it starts), which spreads the work of thousands of matches evenly over the tick period instead
+ * of running them all on one timer edge.
+ *
+ * Usage:
+ *   PongBotServer [--bind ADDR] [--port N] [--unix PATH] [--threads N] [--tick-rate HZ]
+ *   PongBotServer --bench MATCHES [--unix PATH] [--threads N] [--duration SECONDS]
+ *
+ * Serving binds every interface (0.0.0.0) unless --bind says otherwise. --bench binds loopback
+ * and connects 2 * MATCHES synthetic bots over it (or PATH with --unix) and reports
+ * matches hosted per core of server CPU time and the input-to-tick latency (input received ->
+ * state of the tick that applied it sent).
+ */
+#include "../TaskGraph.h"
+#include "BotProtocol.h"
+#include "Net.h"
+
+#include <sys/eventfd.h>
+#include <sys/timerfd.h>
+
+#include <array>
+#include <csignal>
+#include <cstdio>
+#include <cstdlib>
+#include <ctime>
+#include <deque>
+#include <queue>
+#include <string_view>
+#include <unordered_map>
+
+static constexpr int kFieldWidth         = 1920;
+static constexpr int kFieldHeight        = 1080;
+static constexpr int kScoreLimit         = 10;
+static constexpr size_t kMaxBacklog      = 64 * 1024;  // Unsent bytes before a bot is dropped
+static constexpr uint64_t kTimerTag      = 0;
+static constexpr uint64_t kWakeTag       = 1;
+static constexpr uint64_t kFirstBotId    = 2;
+static constexpr uint64_t kListenTcpTag  = 0;
+static constexpr uint64_t kListenUnixTag = 1;
+
+static std::atomic<bool> g_Stop            = false;
+static std::atomic<uint32_t> g_NextMatchId = 1;
+
+struct Options {
+    std::string Bind = "0.0.0.0";
+    uint16_t Port    = 27016;
+    std::string UnixPath;
+    int Threads      = 0;  // 0 = one per core
+    int TickRate     = 60;
+    int BenchMatches = 0;
+    double Duration  = 10;
+};
+
+struct ShardStats {
+    uint64_t MatchesStarted  = 0;
+    uint64_t MatchesFinished = 0;
+    uint64_t Ticks           = 0;
+    uint64_t LateTicks       = 0;  // Finished more than a tick period after their deadline
+    size_t ActiveMatches     = 0;
+    double CpuSeconds        = 0;
+    LatencyStats InputToTick;
+    LatencyStats TickLag;  // Deadline -> tick sent
+
+    void Merge(const ShardStats& other) {
+        MatchesStarted += other.MatchesStarted;
+        MatchesFinished += other.MatchesFinished;
+        Ticks += other.Ticks;
+        LateTicks += other.LateTicks;
+        ActiveMatches += other.ActiveMatches;
+        CpuSeconds += other.CpuSeconds;
+        InputToTick.Merge(other.InputToTick);
+        TickLag.Merge(other.TickLag);
+    }
+};
+
+static double ThreadCpuSeconds() {
+    timespec now = {};
+    ::clock_gettime(CLOCK_THREAD_CPUTIME_ID, &now);
+    return static_cast<double>(now.tv_sec) + static_cast<double>(now.tv_nsec) * 1e-9;
+}
+
+static double Micros(const Net::Clock::duration duration) {
+    return std::chrono::duration<double, std::micro>(duration).count();
+}
+
+class Shard {
+public:
+    explicit Shard(const int tickRate)
+        : m_Period(std::chrono::nanoseconds(1'000'000'000L / tickRate)) {
+        m_Epoll.Reset(::epoll_create1(0));
+        m_Timer.Reset(::timerfd_create(CLOCK_MONOTONIC, TFD_NONBLOCK));
+        m_Wake.Reset(::eventfd(0, EFD_NONBLOCK));
+        if (!m_Epoll.IsValid() || !m_Timer.IsValid() || !m_Wake.IsValid()) {
+            throw NetError("epoll/timerfd/eventfd");
+        }
+
+        Net::EpollAdd(m_Epoll.Get(), m_Timer.Get(), EPOLLIN, kTimerTag);
+        Net::EpollAdd(m_Epoll.Get(), m_Wake.Get(), EPOLLIN, kWakeTag);
+    }
+
+    // Called from the acceptor thread; the shard takes ownership of `fd`
+    void Adopt(const int fd) {
+        {
+            std::lock_guard lock(m_IncomingMutex);
+            m_Incoming.push_back(fd);
+        }
+        const uint64_t one = 1;
+        ::write(m_Wake.Get(), &one, sizeof(one));
+    }
+
+    // Only valid once Run() has returned
+    [[nodiscard]] ShardStats& Stats() {
+        return m_Stats;
+    }
+
+    void Run() {
+        std::vector<epoll_event> events(1024);
+        while (!g_Stop) {
+            ArmTimer();
+
+            const int count = ::epoll_wait(m_Epoll.Get(), events.data(), 1024, 100);
+            const auto now  = Net::Clock::now();
+            for (int i = 0; i < count; ++i) {
+                const uint64_t tag = events[i].data.u64;
+                if (tag == kTimerTag) {
+                    uint64_t expirations = 0;
+                    ::read(m_Timer.Get(), &expirations, sizeof(expirations));
+                } else if (tag == kWakeTag) {
+                    AdoptIncoming();
+                } else {
+                    OnBotEvent(tag, events[i].events, now);
+                }
+            }
+
+            RunDueTicks();
+            DropDeadBots();
+        }
+
+        m_Stats.ActiveMatches = m_Matches.size();
+        m_Stats.CpuSeconds    = ThreadCpuSeconds();
+    }
+
+private:
+    struct Bot {
+        UniqueFd Fd;
+        std::vector<uint8_t> In;
+        std::vector<uint8_t> Out;
+        uint32_t MatchId = 0;
+        int Side         = 0;
+        int8_t Move      = 0;
+        bool Queued      = false;
+        bool Dead        = false;
+        bool HasInput    = false;  // An input arrived that no tick has applied yet
+        Net::Clock::time_point InputTime;
+    };
+
+    struct HostedMatch {
+        Match Game;
+        uint32_t Tick = 0;
+        std::array<uint64_t, 2> Bots;
+        Net::Clock::time_point Deadline;
+    };
+
+    using Deadline = std::pair<Net::Clock::time_point, uint32_t>;
+
+    Net::Clock::duration m_Period;
+
+    UniqueFd m_Epoll;
+    UniqueFd m_Timer;
+    UniqueFd m_Wake;
+    Net::Clock::time_point m_ArmedDeadline;
+
+    std::mutex m_IncomingMutex;
+    std::vector<int> m_Incoming;
+
+    uint64_t m_NextBotId = kFirstBotId;
+    std::unordered_map<uint64_t, std::unique_ptr<Bot>> m_Bots;
+    std::unordered_map<uint32_t, std::unique_ptr<HostedMatch>> m_Matches;
+    std::deque<uint64_t> m_Waiting;
+    std::vector<uint64_t> m_Dead;
+
+    // Earliest deadline first. Ended matches are skipped when they reach the top.
+    std::priority_queue<Deadline, std::vector<Deadline>, std::greater<>> m_Schedule;
+
+    ShardStats m_Stats;
+
+    Bot* FindBot(const uint64_t id) {
+        const auto it = m_Bots.find(id);
+        return it != m_Bots.end() && !it->second->Dead ? it->second.get() : nullptr;
+    }
+
+    void ArmTimer() {
+        const auto deadline =
+          m_Schedule.empty() ? Net::Clock::time_point() : m_Schedule.top().first;
+        if (deadline == m_ArmedDeadline) {
+            return;
+        }
+        m_ArmedDeadline = deadline;
+
+        // steady_clock is CLOCK_MONOTONIC, so deadlines can be handed to the timer as they are.
+        // An all-zero value disarms it.
+        const auto ns    = std::chrono::nanoseconds(deadline.time_since_epoch()).count();
+        itimerspec timer = {};
+        timer.it_value   = {static_cast<time_t>(ns / 1'000'000'000), ns % 1'000'000'000};
+        ::timerfd_settime(m_Timer.Get(), TFD_TIMER_ABSTIME, &timer, nullptr);
+    }
+
+    void AdoptIncoming() {
+        uint64_t count = 0;
+        ::read(m_Wake.Get(), &count, sizeof(count));
+
+        std::vector<int> incoming;
+        {
+            std::lock_guard lock(m_IncomingMutex);
+            incoming.swap(m_Incoming);
+        }
+
+        for (const int fd : incoming) {
+            const uint64_t id = m_NextBotId++;
+            auto bot          = std::make_unique<Bot>();
+            bot->Fd.Reset(fd);
+
+            // A connection the shard cannot watch is closed along with `bot`; the rest carry on
+            try {
+                Net::EpollAdd(m_Epoll.Get(), fd, EPOLLIN, id);
+            } catch (const NetError& err) {
+                std::fprintf(stderr, "PongBotServer: dropping connection: %s\n", err.what());
+                continue;
+            }
+            m_Bots[id] = std::move(bot);
+        }
+    }
+
+    void OnBotEvent(const uint64_t id, const uint32_t events, const Net::Clock::time_point now) {
+        Bot* bot = FindBot(id);
+        if (!bot) {
+            return;
+        }
+
+        if (events & (EPOLLHUP | EPOLLERR)) {
+            Kill(id, *bot);
+            return;
+        }
+
+        if (events & EPOLLIN) {
+            std::array<uint8_t, 4096> buffer;
+            for (;;) {
+                const ssize_t size = ::recv(bot->Fd.Get(), buffer.data(), buffer.size(), 0);
+                if (size == 0 || (size < 0 && errno != EAGAIN)) {
+                    Kill(id, *bot);
+                    return;
+                }
+                if (size < 0) {
+                    break;
+                }
+                bot->In.insert(bot->In.end(), buffer.begin(), buffer.begin() + size);
+                if (static_cast<size_t>(size) < buffer.size()) {
+                    break;
+                }
+            }
+
+            size_t offset = 0;
+            while (offset < bot->In.size()) {
+                const size_t size = BotProtocol::MessageSize(bot->In[offset]);
+                if (size == 0) {
+                    Kill(id, *bot);  // Garbage: there is no way to resynchronize
+                    return;
+                }
+                if (bot->In.size() - offset < size) {
+                    break;
+                }
+                OnMessage(id, *bot, bot->In.data() + offset, now);
+                offset += size;
+            }
+            bot->In.erase(bot->In.begin(), bot->In.begin() + static_cast<ptrdiff_t>(offset));
+        }
+
+        if ((events & EPOLLOUT) && !bot->Dead) {
+            Flush(id, *bot);
+        }
+    }
+
+    void OnMessage(const uint64_t id,
+                   Bot& bot,
+                   const uint8_t* message,
+                   const Net::Clock::time_point now) {
+        switch (message[0]) {
+            case BotProtocol::kJoin:
+                if (bot.MatchId == 0 && !bot.Queued) {
+                    Enqueue(id, bot);
+                    PairWaiting();
+                }
+                break;
+            case BotProtocol::kInput:
+                if (bot.MatchId != 0) {
+                    const auto move = static_cast<int8_t>(message[5]);
+                    bot.Move        = static_cast<int8_t>((move > 0) - (move < 0));
+                    if (!bot.HasInput) {
+                        bot.HasInput  = true;
+                        bot.InputTime = now;
+                    }
+                }
+                break;
+            default:
+                break;  // Server -> bot messages; ignore them
+        }
+    }
+
+    void Enqueue(const uint64_t id, Bot& bot) {
+        bot.MatchId  = 0;
+        bot.Move     = 0;
+        bot.HasInput = false;
+        bot.Queued   = true;
+        m_Waiting.push_back(id);
+    }
+
+    void PairWaiting() {
+        std::array<uint64_t, 2> pair = {};
+        size_t found                 = 0;
+
+        while (!m_Waiting.empty()) {
+            const uint64_t id = m_Waiting.front();
+            m_Waiting.pop_front();
+
+            const Bot* bot = FindBot(id);
+            if (!bot || !bot->Queued) {
+                continue;  // Left while waiting
+            }
+            pair[found++] = id;
+            if (found == 2) {
+                StartMatch(pair);
+                found = 0;
+            }
+        }
+
+        if (found == 1) {
+            m_Waiting.push_front(pair[0]);
+        }
+    }
+
+    void StartMatch(const std::array<uint64_t, 2>& bots) {
+        const uint32_t matchId = g_NextMatchId++;
+
+        auto hosted      = std::make_unique<HostedMatch>();
+        hosted->Game     = Match(kFieldWidth, kFieldHeight, kScoreLimit);
+        hosted->Bots     = bots;
+        hosted->Deadline = Net::Clock::now() + m_Period;
+        m_Schedule.emplace(hosted->Deadline, matchId);
+
+        std::array<uint8_t, BotProtocol::kWelcomeSize> welcome = {BotProtocol::kWelcome};
+        Net::PutU32(welcome.data() + 1, matchId);
+        for (int side = 0; side < 2; ++side) {
+            Bot& bot    = *m_Bots[bots[side]];
+            bot.Queued  = false;
+            bot.MatchId = matchId;
+            bot.Side    = side;
+            welcome[5]  = static_cast<uint8_t>(side);
+            Send(bots[side], bot, welcome.data(), welcome.size());
+        }
+
+        m_Matches[matchId] = std::move(hosted);
+        m_Stats.MatchesStarted++;
+    }
+
+    void EndMatch(const uint32_t matchId, const bool finished) {
+        const auto it = m_Matches.find(matchId);
+        if (it == m_Matches.end()) {
+            return;
+        }
+        const auto hosted = std::move(it->second);
+        m_Matches.erase(it);
+
+        const GameState& state = hosted->Game.State;
+        for (int side = 0; side < 2; ++side) {
+            Bot* bot = FindBot(hosted->Bots[side]);
+            if (!bot) {
+                continue;
+            }
+
+            auto result = BotProtocol::Result::OpponentLeft;
+            if (finished) {
+                const int own   = side == 0 ? state.PlayerScore : state.OpponentScore;
+                const int other = side == 0 ? state.OpponentScore : state.PlayerScore;
+                result          = own > other   ? BotProtocol::Result::Won
+                                  : own < other ? BotProtocol::Result::Lost
+                                                : BotProtocol::Result::Tie;
+            }
+
+            const std::array<uint8_t, BotProtocol::kEndSize> end = {
+              BotProtocol::kEnd, static_cast<uint8_t>(result)};
+            Send(hosted->Bots[side], *bot, end.data(), end.size());
+            if (!bot->Dead) {
+                Enqueue(hosted->Bots[side], *bot);
+            }
+        }
+
+        if (finished) {
+            m_Stats.MatchesFinished++;
+        }
+        PairWaiting();
+    }
+
+    void RunDueTicks() {
+        const auto now = Net::Clock::now();
+        while (!m_Schedule.empty() && m_Schedule.top().first <= now) {
+            const auto [deadline, matchId] = m_Schedule.top();
+            m_Schedule.pop();
+
+            const auto it = m_Matches.find(matchId);
+            if (it == m_Matches.end() || it->second->Deadline != deadline) {
+                continue;
+            }
+
+            HostedMatch& hosted = *it->second;
+            if (TickMatch(hosted)) {
+                EndMatch(matchId, true);
+                continue;
+            }
+
+            // A shard that fell behind skips the missed ticks instead of bursting through them
+            hosted.Deadline += m_Period;
+            if (hosted.Deadline <= now) {
+                hosted.Deadline = now + m_Period;
+            }
+            m_Schedule.emplace(hosted.Deadline, matchId);
+        }
+    }
+
+    // Returns whether the match is over
+    bool TickMatch(HostedMatch& hosted) {
+        std::array<Bot*, 2> bots = {FindBot(hosted.Bots[0]), FindBot(hosted.Bots[1])};
+
+        if (bots[0] && bots[0]->Move != 0) {
+            Physics::NudgePaddle(hosted.Game.Player, bots[0]->Move);
+        }
+        if (bots[1] && bots[1]->Move != 0) {
+            Physics::NudgePaddle(hosted.Game.Opponent, bots[1]->Move);
+        }
+        hosted.Game.Tick();
+        ++hosted.Tick;
+
+        std::array<uint8_t, BotProtocol::kStateSize> state;
+        for (int side = 0; side < 2; ++side) {
+            if (bots[side]) {
+                BotProtocol::EncodeState(hosted.Game, hosted.Tick, side, state.data());
+                Send(hosted.Bots[side], *bots[side], state.data(), state.size());
+            }
+        }
+
+        const auto done = Net::Clock::now();
+        for (Bot* bot : bots) {
+            if (bot && bot->HasInput) {
+                m_Stats.InputToTick.Add(Micros(done - bot->InputTime));
+                bot->HasInput = false;
+            }
+        }
+
+        const auto lag = done - hosted.Deadline;
+        m_Stats.TickLag.Add(Micros(lag));
+        m_Stats.LateTicks += lag > m_Period ? 1 : 0;
+        m_Stats.Ticks++;
+
+        return hosted.Game.IsOver();
+    }
+
+    void Send(const uint64_t id, Bot& bot, const uint8_t* data, const size_t size) {
+        if (bot.Dead) {
+            return;
+        }
+
+        size_t written = 0;
+        if (bot.Out.empty()) {
+            const ssize_t result = ::send(bot.Fd.Get(), data, size, MSG_NOSIGNAL);
+            if (result < 0 && errno != EAGAIN) {
+                Kill(id, bot);
+                return;
+            }
+            written = result > 0 ? static_cast<size_t>(result) : 0;
+            if (written == size) {
+                return;
+            }
+            Net::EpollModify(m_Epoll.Get(), bot.Fd.Get(), EPOLLIN | EPOLLOUT, id);
+        }
+
+        bot.Out.insert(bot.Out.end(), data + written, data + size);
+        if (bot.Out.size() > kMaxBacklog) {
+            Kill(id, bot);  // Not reading its state: the bot is stuck or gone
+        }
+    }
+
+    void Flush(const uint64_t id, Bot& bot) {
+        const ssize_t written = ::send(bot.Fd.Get(), bot.Out.data(), bot.Out.size(), MSG_NOSIGNAL);
+        if (written < 0 && errno != EAGAIN) {
+            Kill(id, bot);
+            return;
+        }
+        if (written > 0) {
+            bot.Out.erase(bot.Out.begin(), bot.Out.begin() + written);
+        }
+        if (bot.Out.empty()) {
+            Net::EpollModify(m_Epoll.Get(), bot.Fd.Get(), EPOLLIN, id);
+        }
+    }
+
+    // Bots are only marked here and removed after the current pass, so no caller is left holding a
+    // dangling Bot& or HostedMatch&
+    void Kill(const uint64_t id, Bot& bot) {
+        if (!bot.Dead) {
+            bot.Dead = true;
+            m_Dead.push_back(id);
+        }
+    }
+
+    void DropDeadBots() {
+        while (!m_Dead.empty()) {
+            std::vector<uint64_t> dead;
+            dead.swap(m_Dead);
+
+            for (const uint64_t id : dead) {
+                const auto it = m_Bots.find(id);
+                if (it == m_Bots.end()) {
+                    continue;
+                }
+                const uint32_t matchId = it->second->MatchId;
+                Net::EpollRemove(m_Epoll.Get(), it->second->Fd.Get());
+                m_Bots.erase(it);
+
+                if (matchId != 0) {
+                    EndMatch(matchId, false);  // May kill the opponent too; the loop picks it up
+                }
+            }
+        }
+    }
+};
+
+/*
+ * Accepts connections on the main thread and deals them out to the shards.
+ */
+class BotServer {
+public:
+    BotServer(const Options& options, const size_t shards) {
+        for (size_t i = 0; i < shards; ++i) {
+            m_Shards.push_back(std::make_unique<Shard>(options.TickRate));
+        }
+
+        m_Epoll.Reset(::epoll_create1(0));
+        if (!m_Epoll.IsValid()) {
+            throw NetError("epoll_create1");
+        }
+
+        m_ListenTcp = Net::ListenTcp(Net::ParseAddress(options.Bind, options.Port));
+        Net::EpollAdd(m_Epoll.Get(), m_ListenTcp.Get(), EPOLLIN, kListenTcpTag);
+        if (!options.UnixPath.empty()) {
+            m_ListenUnix = Net::ListenUnix(options.UnixPath);
+            m_UnixPath   = options.UnixPath;
+            Net::EpollAdd(m_Epoll.Get(), m_ListenUnix.Get(), EPOLLIN, kListenUnixTag);
+        }
+    }
+
+    ~BotServer() {
+        if (!m_UnixPath.empty()) {
+            ::unlink(m_UnixPath.c_str());
+        }
+    }
+
+    [[nodiscard]] uint16_t Port() const {
+        return Net::LocalPort(m_ListenTcp.Get());
+    }
+
+    // Runs the shards on `pool` and accepts connections until g_Stop; returns once all shards
+    // have stopped
+    ShardStats Run(ThreadPool& pool) {
+        std::vector<std::future<void>> running;
+        for (const auto& shard : m_Shards) {
+            // A shard that dies stops the server too, instead of being dealt connections that no
+            // one serves until shutdown
+            auto job = std::make_shared<std::packaged_task<void()>>([&shard] {
+                try {
+                    shard->Run();
+                } catch (...) {
+                    g_Stop = true;
+                    throw;
+                }
+            });
+            running.push_back(job->get_future());
+            pool.Enqueue([job] { (*job)(); });
+        }
+
+        std::array<epoll_event, 2> events;
+        while (!g_Stop) {
+            const int count = ::epoll_wait(m_Epoll.Get(), events.data(), 2, 100);
+            for (int i = 0; i < count; ++i) {
+                const bool isTcp = events[i].data.u64 == kListenTcpTag;
+                Accept(isTcp ? m_ListenTcp.Get() : m_ListenUnix.Get(), isTcp);
+            }
+        }
+
+        ShardStats total;
+        for (size_t i = 0; i < m_Shards.size(); ++i) {
+            running[i].get();
+            total.Merge(m_Shards[i]->Stats());
+        }
+        return total;
+    }
+
+private:
+    std::vector<std::unique_ptr<Shard>> m_Shards;
+    size_t m_NextShard = 0;
+
+    UniqueFd m_Epoll;
+    UniqueFd m_ListenTcp;
+    UniqueFd m_ListenUnix;
+    std::string m_UnixPath;
+    Net::FdReserve m_FdReserve;
+
+    void Accept(const int listen, const bool isTcp) {
+        for (;;) {
+            const int fd = ::accept4(listen, nullptr, nullptr, SOCK_NONBLOCK);
+            if (fd < 0) {
+                if ((errno == EMFILE || errno == ENFILE) && m_FdReserve.Shed(listen)) {
+                    continue;
+                }
+                return;
+            }
+            if (isTcp) {
+                Net::SetNoDelay(fd);
+            }
+            m_Shards[m_NextShard++ % m_Shards.size()]->Adopt(fd);
+        }
+    }
+};
+
+/*
+ * Synthetic bots for --bench. Each one joins, chases the ball and answers every state with an
+ * input, like a real bot polling as fast as the server ticks.
+ */
+class BotSwarm {
+public:
+    struct Totals {
+        std::atomic<uint64_t> States {0};
+        std::atomic<uint64_t> Inputs {0};
+        std::atomic<uint64_t> Results {0};
+    };
+
+    BotSwarm(const Options& options, const uint16_t port, const int bots, const int threads) {
+        for (int t = 0; t < threads; ++t) {
+            const int count = bots / threads + (t < bots % threads ? 1 : 0);
+            m_Threads.emplace_back([this, options, port, count] {
+                BotLoop(options.UnixPath, port, count);
+            });
+        }
+    }
+
+    ~BotSwarm() {
+        Stop();
+    }
+
+    void Stop() {
+        m_Stop = true;
+        for (auto& thread : m_Threads) {
+            if (thread.joinable()) {
+                thread.join();
+            }
+        }
+    }
+
+    [[nodiscard]] const Totals& Results() const {
+        return m_Totals;
+    }
+
+private:
+    struct Client {
+        UniqueFd Fd;
+        std::vector<uint8_t> Stream;
+    };
+
+    std::vector<std::thread> m_Threads;
+    std::atomic<bool> m_Stop = false;
+    Totals m_Totals;
+
+    static int8_t Chase(const BotProtocol::State& state) {
+        const int32_t offset = state.BallY - state.OwnY;
+        if (offset > kPaddleStep.Raw) {
+            return 1;
+        }
+        if (offset < -kPaddleStep.Raw) {
+            return -1;
+        }
+        return 0;
+    }
+
+    void OnMessage(Client& client, const uint8_t* message) {
+        if (message[0] == BotProtocol::kState) {
+            const auto state = BotProtocol::DecodeState(message);
+            std::array<uint8_t, BotProtocol::kInputSize> input;
+            BotProtocol::EncodeInput(state.Tick, Chase(state), input.data());
+            ::send(client.Fd.Get(), input.data(), input.size(), MSG_NOSIGNAL);
+            m_Totals.States++;
+            m_Totals.Inputs++;
+        } else if (message[0] == BotProtocol::kEnd) {
+            m_Totals.Results++;
+        }
+    }
+
+    void BotLoop(const std::string& unixPath, const uint16_t port, const int count) {
+        UniqueFd epoll(::epoll_create1(0));
+        std::vector<std::unique_ptr<Client>> clients;
+
+        for (int i = 0; i < count; ++i) {
+            auto client = std::make_unique<Client>();
+            client->Fd  = unixPath.empty() ? Net::ConnectTcp(Net::LoopbackAddress(port))
+                                           : Net::ConnectUnix(unixPath);
+            Net::SetNonBlocking(client->Fd.Get());
+
+            const uint8_t join = BotProtocol::kJoin;
+            ::send(client->Fd.Get(), &join, 1, MSG_NOSIGNAL);
+
+            Net::EpollAdd(epoll.Get(), client->Fd.Get(), EPOLLIN, clients.size());
+            clients.push_back(std::move(client));
+        }
+
+        std::vector<epoll_event> events(1024);
+        std::array<uint8_t, 4096> buffer;
+        while (!m_Stop) {
+            const int ready = ::epoll_wait(epoll.Get(), events.data(), 1024, 50);
+            for (int i = 0; i < ready; ++i) {
+                Client& client = *clients[events[i].data.u64];
+                for (;;) {
+                    const ssize_t size =
+                      ::recv(client.Fd.Get(), buffer.data(), buffer.size(), MSG_DONTWAIT);
+                    if (size <= 0) {
+                        break;
+                    }
+                    client.Stream.insert(client.Stream.end(),
+                                         buffer.begin(),
+                                         buffer.begin() + size);
+                }
+
+                size_t offset = 0;
+                while (offset < client.Stream.size()) {
+                    const size_t size = BotProtocol::MessageSize(client.Stream[offset]);
+                    if (size == 0 || client.Stream.size() - offset < size) {
+                        break;
+                    }
+                    OnMessage(client, client.Stream.data() + offset);
+                    offset += size;
+                }
+                client.Stream.erase(client.Stream.begin(),
+                                    client.Stream.begin() + static_cast<ptrdiff_t>(offset));
+            }
+        }
+    }
+};
+
+static Options ParseOptions(const int argc, char** argv) {
+    Options options;
+    for (int i = 1; i < argc; ++i) {
+        const std::string_view arg = argv[i];
+        const bool hasValue        = i + 1 < argc;
+        if (arg == "--bind" && hasValue) {
+            options.Bind = argv[++i];
+        } else if (arg == "--port" && hasValue) {
+            options.Port = static_cast<uint16_t>(std::atoi(argv[++i]));
+        } else if (arg == "--unix" && hasValue) {
+            options.UnixPath = argv[++i];
+        } else if (arg == "--threads" && hasValue) {
+            options.Threads = std::max(1, std::atoi(argv[++i]));
+        } else if (arg == "--tick-rate" && hasValue) {
+            options.TickRate = std::max(1, std::atoi(argv[++i]));
+        } else if (arg == "--bench" && hasValue) {
+            options.BenchMatches = std::atoi(argv[++i]);
+        } else if (arg == "--duration" && hasValue) {
+            options.Duration = std::atof(argv[++i]);
+        } else {
+            std::fprintf(stderr, "Unknown argument: %s\n", argv[i]);
+            std::exit(1);
+        }
+    }
+    return options;
+}
+
+static void PrintReport(ShardStats& stats, const Options& options, const double seconds) {
+    const auto ticks       = static_cast<double>(stats.Ticks);
+    const double expected  = seconds * options.TickRate;
+    const double hosted    = expected > 0 ? ticks / expected : 0;  // Matches at full tick rate
+    const double coresUsed = seconds > 0 ? stats.CpuSeconds / seconds : 0;
+
+    std::printf("matches started:       %llu (%llu finished)\n",
+                static_cast<unsigned long long>(stats.MatchesStarted),
+                static_cast<unsigned long long>(stats.MatchesFinished));
+    std::printf("matches hosted:        %.0f (%zu active at exit)\n", hosted, stats.ActiveMatches);
+    std::printf("ticks:                 %llu (%.2f%% late)\n",
+                static_cast<unsigned long long>(stats.Ticks),
+                ticks > 0 ? 100.0 * static_cast<double>(stats.LateTicks) / ticks : 0);
+    std::printf("server cores used:     %.2f\n", coresUsed);
+    std::printf("matches per core:      %.0f\n", coresUsed > 0 ? hosted / coresUsed : 0);
+    std::printf("tick lag p50/p99:      %.1f / %.1f us\n",
+                stats.TickLag.Percentile(50),
+                stats.TickLag.Percentile(99));
+    std::printf("input-to-tick p50/p99: %.1f / %.1f us\n",
+                stats.InputToTick.Percentile(50),
+                stats.InputToTick.Percentile(99));
+}
+
+int main(const int argc, char** argv) {
+    Options options = ParseOptions(argc, argv);
+    std::signal(SIGINT, [](int) { g_Stop = true; });
+    std::signal(SIGTERM, [](int) { g_Stop = true; });
+    std::signal(SIGPIPE, SIG_IGN);
+
+    const auto cores = std::max(1, static_cast<int>(std::thread::hardware_concurrency()));
+    const int shards = options.Threads > 0 ? options.Threads : cores;
+
+    try {
+        Net::RaiseFdLimit();
+        ThreadPool pool(static_cast<size_t>(shards));
+
+        if (options.BenchMatches == 0) {
+            BotServer server(options, static_cast<size_t>(shards));
+            std::printf("Bot server on %s:%u%s%s, %d shards, %d Hz\n",
+                        options.Bind.c_str(),
+                        server.Port(),
+                        options.UnixPath.empty() ? "" : " and ",
+                        options.UnixPath.c_str(),
+                        shards,
+                        options.TickRate);
+            server.Run(pool);
+            return 0;
+        }
+
+        options.Bind = "127.0.0.1";
+        options.Port = 0;
+        BotServer server(options, static_cast<size_t>(shards));
+
+        const int botThreads = std::clamp(cores / 2, 1, 4);
+        BotSwarm swarm(options, server.Port(), options.BenchMatches * 2, botThreads);
+
+        std::thread timer([&] {
+            std::this_thread::sleep_for(std::chrono::duration<double>(options.Duration));
+            g_Stop = true;
+        });
+        ShardStats stats = server.Run(pool);
+        timer.join();
+        swarm.Stop();
+
+        PrintReport(stats, options, options.Duration);
+        const auto& results = swarm.Results();
+        std::printf("bot states/inputs:     %llu / %llu\n",
+                    static_cast<unsigned long long>(results.States.load()),
+                    static_cast<unsigned long long>(results.Inputs.load()));
+    } catch (const std::exception& err) {
+        std::fprintf(stderr, "PongBotServer: %s\n", err.what());
+        return 1;
+    }
+
+    return 0;
+}
@@ -0,0 +1,381 @@
+#pragma once
+
+/*
+ * Small POSIX socket helpers shared by the headless servers. Linux only (epoll).
+ */
+#include <arpa/inet.h>
+#include <fcntl.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/epoll.h>
+#include <sys/resource.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <bit>
+#include <cerrno>
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+class NetError final : public std::exception {
+public:
+    explicit NetError(const std::string& what) : message(what + ": " + std::strerror(errno)) {}
+
+    [[nodiscard]] const char* what() const noexcept override {
+        return message.c_str();
+    }
+
+private:
+    std::string message;
+};
+
+// Owning file descriptor
+class UniqueFd {
+public:
+    UniqueFd() = default;
+
+    explicit UniqueFd(const int fd) : m_Fd(fd) {}
+
+    UniqueFd(UniqueFd&& other) noexcept : m_Fd(std::exchange(other.m_Fd, -1)) {}
+
+    UniqueFd& operator=(UniqueFd&& other) noexcept {
+        if (this != &other) {
+            Reset(std::exchange(other.m_Fd, -1));
+        }
+        return *this;
+    }
+
+    UniqueFd(const UniqueFd&)            = delete;
+    UniqueFd& operator=(const UniqueFd&) = delete;
+
+    ~UniqueFd() {
+        Reset();
+    }
+
+    void Reset(const int fd = -1) {
+        if (m_Fd >= 0) {
+            ::close(m_Fd);
+        }
+        m_Fd = fd;
+    }
+
+    [[nodiscard]] int Get() const {
+        return m_Fd;
+    }
+
+    [[nodiscard]] bool IsValid() const {
+        return m_Fd >= 0;
+    }
+
+private:
+    int m_Fd = -1;
+};
+
+namespace Net {
+    using Clock = std::chrono::steady_clock;
+
+    inline void SetNonBlocking(const int fd) {
+        const int flags = ::fcntl(fd, F_GETFL, 0);
+        if (flags < 0 || ::fcntl(fd, F_SETFL, flags | O_NONBLOCK) < 0) {
+            throw NetError("fcntl(O_NONBLOCK)");
+        }
+    }
+
+    inline void SetNoDelay(const int fd) {
+        constexpr int enable = 1;
+        ::setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &enable, sizeof(enable));
+    }
+
+    inline void SetBufferSizes(const int fd, const int bytes) {
+        ::setsockopt(fd, SOL_SOCKET, SO_SNDBUF, &bytes, sizeof(bytes));
+        ::setsockopt(fd, SOL_SOCKET, SO_RCVBUF, &bytes, sizeof(bytes));
+    }
+
+    // Thousands of sockets do not fit in the default soft limit of 1024
+    inline void RaiseFdLimit() {
+        rlimit limit = {};
+        if (::getrlimit(RLIMIT_NOFILE, &limit) == 0 && limit.rlim_cur < limit.rlim_max) {
+            limit.rlim_cur = limit.rlim_max;
+            ::setrlimit(RLIMIT_NOFILE, &limit);
+        }
+    }
+
+    inline sockaddr_in LoopbackAddress(const uint16_t port) {
+        sockaddr_in address     = {};
+        address.sin_family      = AF_INET;
+        address.sin_port        = htons(port);
+        address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        return address;
+    }
+
+    // `host` is a dotted IPv4 address, e.g. "0.0.0.0" for every interface
+    inline sockaddr_in ParseAddress(const std::string& host, const uint16_t port) {
+        sockaddr_in address = {};
+        address.sin_family  = AF_INET;
+        address.sin_port    = htons(port);
+        if (::inet_pton(AF_INET, host.c_str(), &address.sin_addr) != 1) {
+            errno = EINVAL;
+            throw NetError("address " + host);
+        }
+        return address;
+    }
+
+    inline uint16_t LocalPort(const int fd) {
+        sockaddr_in address = {};
+        socklen_t length    = sizeof(address);
+        if (::getsockname(fd, reinterpret_cast<sockaddr*>(&address), &length) != 0) {
+            throw NetError("getsockname");
+        }
+        return ntohs(address.sin_port);
+    }
+
+    inline UniqueFd BindUdp(const sockaddr_in& address) {
+        UniqueFd fd(::socket(AF_INET, SOCK_DGRAM | SOCK_NONBLOCK, 0));
+        if (!fd.IsValid()) {
+            throw NetError("socket(UDP)");
+        }
+        if (::bind(fd.Get(), reinterpret_cast<const sockaddr*>(&address), sizeof(address)) != 0) {
+            throw NetError("bind(UDP)");
+        }
+        return fd;
+    }
+
+    inline UniqueFd ListenTcp(const sockaddr_in& address) {
+        UniqueFd fd(::socket(AF_INET, SOCK_STREAM | SOCK_NONBLOCK, 0));
+        if (!fd.IsValid()) {
+            throw NetError("socket(TCP)");
+        }
+
+        constexpr int enable = 1;
+        ::setsockopt(fd.Get(), SOL_SOCKET, SO_REUSEADDR, &enable, sizeof(enable));
+        if (::bind(fd.Get(), reinterpret_cast<const sockaddr*>(&address), sizeof(address)) != 0) {
+            throw NetError("bind(TCP)");
+        }
+        if (::listen(fd.Get(), SOMAXCONN) != 0) {
+            throw NetError("listen");
+        }
+        return fd;
+    }
+
+    // One descriptor held back for when the process runs out. A connection that cannot be accepted
+    // for EMFILE stays queued and keeps a level-triggered listen socket readable, so epoll would
+    // spin; giving up the reserve lets it be accepted and closed straight away instead.
+    class FdReserve {
+    public:
+        FdReserve() {
+            Refill();
+        }
+
+        // Drops one pending connection on `listen`. Returns false if there was none or the
+        // reserve could not make room for it.
+        bool Shed(const int listen) {
+            m_Fd.Reset();
+            const int fd = ::accept4(listen, nullptr, nullptr, SOCK_CLOEXEC);
+            if (fd >= 0) {
+                ::close(fd);
+            }
+            Refill();
+            return fd >= 0;
+        }
+
+    private:
+        UniqueFd m_Fd;
+
+        void Refill() {
+            m_Fd.Reset(::open("/dev/null", O_RDONLY | O_CLOEXEC));
+        }
+    };
+
+    inline sockaddr_un UnixAddress(const std::string& path) {
+        sockaddr_un address = {};
+        address.sun_family  = AF_UNIX;
+        if (path.size() >= sizeof(address.sun_path)) {
+            errno = ENAMETOOLONG;
+            throw NetError("AF_UNIX path");
+        }
+        std::memcpy(address.sun_path, path.c_str(), path.size() + 1);
+        return address;
+    }
+
+    inline UniqueFd ListenUnix(const std::string& path) {
+        UniqueFd fd(::socket(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK, 0));
+        if (!fd.IsValid()) {
+            throw NetError("socket(AF_UNIX)");
+        }
+
+        const auto address = UnixAddress(path);
+        ::unlink(path.c_str());
+        if (::bind(fd.Get(), reinterpret_cast<const sockaddr*>(&address), sizeof(address)) != 0) {
+            throw NetError("bind(AF_UNIX)");
+        }
+        if (::listen(fd.Get(), SOMAXCONN) != 0) {
+            throw NetError("listen");
+        }
+        return fd;
+    }
+
+    inline UniqueFd ConnectUnix(const std::string& path) {
+        UniqueFd fd(::socket(AF_UNIX, SOCK_STREAM, 0));
+        if (!fd.IsValid()) {
+            throw NetError("socket(AF_UNIX)");
+        }
+
+        const auto address = UnixAddress(path);
+        const auto* raw    = reinterpret_cast<const sockaddr*>(&address);
+        if (::connect(fd.Get(), raw, sizeof(address)) != 0) {
+            throw NetError("connect(AF_UNIX)");
+        }
+        return fd;
+    }
+
+    inline UniqueFd ConnectTcp(const sockaddr_in& address) {
+        UniqueFd fd(::socket(AF_INET, SOCK_STREAM, 0));
+        if (!fd.IsValid()) {
+            throw NetError("socket(TCP)");
+        }
+        const auto* raw = reinterpret_cast<const sockaddr*>(&address);
+        if (::connect(fd.Get(), raw, sizeof(address)) != 0) {
+            throw NetError("connect(TCP)");
+        }
+        SetNoDelay(fd.Get());
+        return fd;
+    }
+
+    inline void EpollAdd(const int epoll,
+                         const int fd,
+                         const uint32_t events,
+                         const uint64_t data) {
+        epoll_event event = {};
+        event.events      = events;
+        event.data.u64    = data;
+        if (::epoll_ctl(epoll, EPOLL_CTL_ADD, fd, &event) != 0) {
+            throw NetError("epoll_ctl(ADD)");
+        }
+    }
+
+    inline void EpollModify(const int epoll,
+                            const int fd,
+                            const uint32_t events,
+                            const uint64_t data) {
+        epoll_event event = {};
+        event.events      = events;
+        event.data.u64    = data;
+        ::epoll_ctl(epoll, EPOLL_CTL_MOD, fd, &event);
+    }
+
+    inline void EpollRemove(const int epoll, const int fd) {
+        ::epoll_ctl(epoll, EPOLL_CTL_DEL, fd, nullptr);
+    }
+
+    inline void PutU16(uint8_t* out, const uint16_t value) {
+        out[0] = static_cast<uint8_t>(value);
+        out[1] = static_cast<uint8_t>(value >> 8);
+    }
+
+    inline void PutU32(uint8_t* out, const uint32_t value) {
+        for (int i = 0; i < 4; ++i) {
+            out[i] = static_cast<uint8_t>(value >> (8 * i));
+        }
+    }
+
+    inline void PutU64(uint8_t* out, const uint64_t value) {
+        PutU32(out, static_cast<uint32_t>(value));
+        PutU32(out + 4, static_cast<uint32_t>(value >> 32));
+    }
+
+    inline uint16_t GetU16(const uint8_t* in) {
+        return static_cast<uint16_t>(in[0] | (in[1] << 8));
+    }
+
+    inline uint32_t GetU32(const uint8_t* in) {
+        uint32_t value = 0;
+        for (int i = 0; i < 4; ++i) {
+            value |= static_cast<uint32_t>(in[i]) << (8 * i);
+        }
+        return value;
+    }
+
+    inline uint64_t GetU64(const uint8_t* in) {
+        return GetU32(in) | (static_cast<uint64_t>(GetU32(in + 4)) << 32);
+    }
+
+    // SipHash-2-4 of a 16-byte message (m0, m1): a keyed hash whose key can't be recovered from
+    // its outputs, unlike the plain mixers used elsewhere
+    inline uint64_t SipHash(const uint64_t k0,
+                            const uint64_t k1,
+                            const uint64_t m0,
+                            const uint64_t m1) {
+        uint64_t v0 = k0 ^ 0x736F6D6570736575ull;
+        uint64_t v1 = k1 ^ 0x646F72616E646F6Dull;
+        uint64_t v2 = k0 ^ 0x6C7967656E657261ull;
+        uint64_t v3 = k1 ^ 0x7465646279746573ull;
+
+        const auto round = [&] {
+            v0 += v1;
+            v1 = std::rotl(v1, 13);
+            v1 ^= v0;
+            v0 = std::rotl(v0, 32);
+            v2 += v3;
+            v3 = std::rotl(v3, 16);
+            v3 ^= v2;
+            v0 += v3;
+            v3 = std::rotl(v3, 21);
+            v3 ^= v0;
+            v2 += v1;
+            v1 = std::rotl(v1, 17);
+            v1 ^= v2;
+            v2 = std::rotl(v2, 32);
+        };
+
+        // The last block only carries the message length
+        for (const uint64_t block : {m0, m1, uint64_t(16) << 56}) {
+            v3 ^= block;
+            round();
+            round();
+            v0 ^= block;
+        }
+
+        v2 ^= 0xFF;
+        for (int i = 0; i < 4; ++i) {
+            round();
+        }
+        return v0 ^ v1 ^ v2 ^ v3;
+    }
+}  // namespace Net
+
+// Collects latency samples (in microseconds) and reports percentiles
+class LatencyStats {
+public:
+    void Add(const double micros) {
+        m_Samples.push_back(micros);
+    }
+
+    void Merge(const LatencyStats& other) {
+        m_Samples.insert(m_Samples.end(), other.m_Samples.begin(), other.m_Samples.end());
+    }
+
+    [[nodiscard]] size_t Count() const {
+        return m_Samples.size();
+    }
+
+    // p in [0, 100]
+    [[nodiscard]] double Percentile(const double p) {
+        if (m_Samples.empty()) {
+            return 0;
+        }
+        const auto last = static_cast<double>(m_Samples.size() - 1);
+        const auto rank = static_cast<size_t>(p / 100.0 * last);
+        std::nth_element(m_Samples.begin(), m_Samples.begin() + rank, m_Samples.end());
+        return m_Samples[rank];
+    }
+
+private:
+    std::vector<double> m_Samples;
+};
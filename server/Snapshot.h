@@ -0,0 +1,164 @@
+#pragma once
+
+/*
+ * Compact match snapshots for spectators.
+ *
+ * Snapshot message:
+ *   u8  'S'
+ *   u32 tick
+ *   u32 base tick (0 = keyframe, i.e. delta against an all-zero snapshot)
+ *   u16 mask of fields that differ from the base
+ *   one zigzag varint per set bit: field - base field
+ *
+ * Everything is little-endian. A ball moving in a straight line costs about 15 bytes per tick.
+ */
+#include "../Simulation.h"
+#include "Net.h"
+
+#include <array>
+#include <bit>
+#include <span>
+#include <type_traits>
+#include <vector>
+
+static constexpr uint8_t kSnapshotMessage  = 'S';
+static constexpr size_t kSnapshotHeaderSize = 1 + 4 + 4 + 2;
+
+struct Snapshot {
+    enum Field {
+        BallX,
+        BallY,
+        PlayerX,
+        PlayerY,
+        OpponentX,
+        OpponentY,
+        PlayerScore,
+        OpponentScore,
+        ScoreLimit,
+        FieldCount
+    };
+
+    uint32_t Tick                          = 0;
+    std::array<int32_t, FieldCount> Fields = {};
+
+    static int32_t ScalarBits(const Scalar value) {
+        if constexpr (std::is_same_v<Scalar, Fixed>) {
+            return value.Raw;
+        } else {
+            return std::bit_cast<int32_t>(value);
+        }
+    }
+
+    static Snapshot Capture(const Match& match, const uint32_t tick) {
+        Snapshot snapshot;
+        snapshot.Tick                  = tick;
+        snapshot.Fields[BallX]         = ScalarBits(match.Ball.Position.X);
+        snapshot.Fields[BallY]         = ScalarBits(match.Ball.Position.Y);
+        snapshot.Fields[PlayerX]       = ScalarBits(match.Player.Position.X);
+        snapshot.Fields[PlayerY]       = ScalarBits(match.Player.Position.Y);
+        snapshot.Fields[OpponentX]     = ScalarBits(match.Opponent.Position.X);
+        snapshot.Fields[OpponentY]     = ScalarBits(match.Opponent.Position.Y);
+        snapshot.Fields[PlayerScore]   = match.State.PlayerScore;
+        snapshot.Fields[OpponentScore] = match.State.OpponentScore;
+        snapshot.Fields[ScoreLimit]    = match.State.ScoreLimit;
+        return snapshot;
+    }
+};
+
+static_assert(Snapshot::FieldCount <= 16, "field mask is 16 bits");
+
+namespace SnapshotCodec {
+    inline void PutVarint(std::vector<uint8_t>& out, uint32_t value) {
+        while (value >= 0x80) {
+            out.push_back(static_cast<uint8_t>(value | 0x80));
+            value >>= 7;
+        }
+        out.push_back(static_cast<uint8_t>(value));
+    }
+
+    inline bool GetVarint(const std::span<const uint8_t> in, size_t& offset, uint32_t& value) {
+        value = 0;
+        for (int shift = 0; shift < 35; shift += 7) {
+            if (offset >= in.size()) {
+                return false;
+            }
+            const uint8_t byte = in[offset++];
+            value |= static_cast<uint32_t>(byte & 0x7F) << shift;
+            if (!(byte & 0x80)) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    inline uint32_t ZigZag(const int32_t value) {
+        return (static_cast<uint32_t>(value) << 1) ^ static_cast<uint32_t>(value >> 31);
+    }
+
+    inline int32_t UnZigZag(const uint32_t value) {
+        return static_cast<int32_t>(value >> 1) ^ -static_cast<int32_t>(value & 1);
+    }
+
+    // Appends `current` encoded against `base` (pass an empty Snapshot for a keyframe)
+    inline void Encode(const Snapshot& base, const Snapshot& current, std::vector<uint8_t>& out) {
+        const size_t start = out.size();
+        out.resize(start + kSnapshotHeaderSize);
+
+        uint16_t mask = 0;
+        for (int i = 0; i < Snapshot::FieldCount; ++i) {
+            const int32_t delta = static_cast<int32_t>(static_cast<uint32_t>(current.Fields[i]) -
+                                                       static_cast<uint32_t>(base.Fields[i]));
+            if (delta != 0) {
+                mask |= static_cast<uint16_t>(1u << i);
+                PutVarint(out, ZigZag(delta));
+            }
+        }
+
+        uint8_t* header = out.data() + start;
+        header[0]       = kSnapshotMessage;
+        Net::PutU32(header + 1, current.Tick);
+        Net::PutU32(header + 5, base.Tick);
+        Net::PutU16(header + 9, mask);
+    }
+
+    // Reads the tick and base tick of a snapshot message without decoding it
+    inline bool PeekTicks(const std::span<const uint8_t> message, uint32_t& tick, uint32_t& base) {
+        if (message.size() < kSnapshotHeaderSize || message[0] != kSnapshotMessage) {
+            return false;
+        }
+        tick = Net::GetU32(message.data() + 1);
+        base = Net::GetU32(message.data() + 5);
+        return true;
+    }
+
+    // `base` must be the snapshot whose tick PeekTicks reported (an empty Snapshot for 0)
+    inline bool Decode(const std::span<const uint8_t> message,
+                       const Snapshot& base,
+                       Snapshot& current) {
+        uint32_t tick;
+        uint32_t baseTick;
+        if (!PeekTicks(message, tick, baseTick) || baseTick != base.Tick) {
+            return false;
+        }
+
+        const uint16_t mask = Net::GetU16(message.data() + 9);
+        size_t offset       = kSnapshotHeaderSize;
+
+        current.Tick = tick;
+        for (int i = 0; i < Snapshot::FieldCount; ++i) {
+            current.Fields[i] = base.Fields[i];
+            if (!(mask & (1u << i))) {
+                continue;
+            }
+
+            uint32_t encoded;
+            if (!GetVarint(message, offset, encoded)) {
+                return false;
+            }
+            current.Fields[i] = static_cast<int32_t>(static_cast<uint32_t>(base.Fields[i]) +
+                                                     static_cast<uint32_t>(UnZigZag(encoded)));
+        }
+
+        return offset == message.size();
+    }
+}  // namespace SnapshotCodec
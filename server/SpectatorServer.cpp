@@ -0,0 +1,817 @@
+/*
+ * Spectator broadcast server.
+ *
+ * Runs one authoritative match headlessly and streams it to spectators every tick. UDP spectators
+ * join with a return-routability handshake: 'H' + u64 cookie (0 at first) is answered with
+ * 'C' + u64 cookie of the same size, and only a hello carrying a valid cookie joins, so a spoofed
+ * source address is never streamed to. Joined spectators send 'A' + u32 tick to acknowledge a
+ * snapshot and 'B' to leave; each one gets deltas against its last acknowledged snapshot. TCP spectators get the same messages framed
+ * with a u16 length; the stream is reliable, so their baseline is simply the last snapshot that
+ * was fully written.
+ *
+ * Every distinct (tick, baseline) pair is encoded once per tick and shared by all spectators on
+ * that baseline - normally all of them.
+ *
+ * Usage:
+ *   PongSpectatorServer [--bind ADDR] [--port N] [--tick-rate HZ] [--max-spectators N]
+ *   PongSpectatorServer --bench UDP_CLIENTS [--bench-tcp TCP_CLIENTS] [--duration SECONDS]
+ *
+ * Serving binds every interface (0.0.0.0) unless --bind says otherwise. --bench always binds
+ * loopback, runs simulated spectators over it and reports bytes per client per second and the
+ * tick-to-send latency (simulation step done -> last spectator's send returned).
+ */
+#include "Net.h"
+#include "Snapshot.h"
+
+#include <sys/timerfd.h>
+
+#include <atomic>
+#include <csignal>
+#include <random>
+#include <cstdio>
+#include <cstdlib>
+#include <string_view>
+#include <thread>
+#include <unordered_map>
+
+static constexpr uint8_t kHelloMessage  = 'H';
+static constexpr uint8_t kCookieMessage = 'C';
+static constexpr uint8_t kAckMessage    = 'A';
+static constexpr uint8_t kByeMessage    = 'B';
+static constexpr size_t kHelloSize      = 9;  // 'H'/'C' + u64 cookie
+static constexpr auto kCookieLifetime   = std::chrono::seconds(30);
+static constexpr uint32_t kHistorySize  = 64;  // Oldest baseline a spectator may ack
+static constexpr size_t kSendBatch      = 64;
+static constexpr auto kSpectatorTimeout = std::chrono::seconds(5);
+static constexpr uint64_t kTimerTag     = 0;
+static constexpr uint64_t kUdpTag       = 1;
+static constexpr uint64_t kListenTag    = 2;
+static constexpr uint64_t kTcpTag       = 1ull << 32;
+
+static std::atomic<bool> g_Stop = false;
+
+struct Options {
+    std::string Bind    = "0.0.0.0";
+    uint16_t Port       = 27015;
+    int TickRate        = 60;
+    size_t MaxUdp       = 4096;  // UDP spectators streamed to at once
+    int BenchUdpClients = 0;
+    int BenchTcpClients = 0;
+    double Duration     = 10;
+};
+
+struct SpectatorStats {
+    uint64_t BytesSent    = 0;
+    uint64_t MessagesSent = 0;
+    uint64_t Encodes      = 0;
+    uint64_t Ticks        = 0;
+    uint64_t ClientTicks  = 0;  // Sum over ticks of connected spectators
+    uint64_t UdpRejected  = 0;  // Valid hellos turned away at MaxUdp
+    LatencyStats TickToSend;
+};
+
+/*
+ * Stateless cookies for the UDP handshake: a keyed hash of the source address and the current
+ * time slot. Only someone receiving at that address learns its cookie, and nothing is stored
+ * before the cookie comes back.
+ */
+class CookieJar {
+public:
+    CookieJar() : m_Epoch(Net::Clock::now()) {
+        std::random_device random;
+        for (uint64_t* key : {&m_Key0, &m_Key1}) {
+            *key = (static_cast<uint64_t>(random()) << 32) | random();
+        }
+    }
+
+    [[nodiscard]] uint64_t Issue(const sockaddr_in& address, const Net::Clock::time_point now) {
+        return For(address, SlotAt(now));
+    }
+
+    // Cookies from the previous slot still count, so one issued just before a rollover works
+    [[nodiscard]] bool IsValid(const sockaddr_in& address,
+                               const uint64_t cookie,
+                               const Net::Clock::time_point now) const {
+        const uint64_t slot = SlotAt(now);
+        return cookie == For(address, slot) || (slot > 0 && cookie == For(address, slot - 1));
+    }
+
+private:
+    uint64_t m_Key0 = 0;
+    uint64_t m_Key1 = 0;
+    Net::Clock::time_point m_Epoch;
+
+    [[nodiscard]] uint64_t SlotAt(const Net::Clock::time_point now) const {
+        return static_cast<uint64_t>((now - m_Epoch) / kCookieLifetime);
+    }
+
+    [[nodiscard]] uint64_t For(const sockaddr_in& address, const uint64_t slot) const {
+        const uint64_t where = (static_cast<uint64_t>(address.sin_addr.s_addr) << 16) |
+                               address.sin_port;
+        return Net::SipHash(m_Key0, m_Key1, where, slot);
+    }
+};
+
+class SpectatorServer {
+public:
+    explicit SpectatorServer(const Options& options)
+        : m_Options(options), m_Match(1920, 1080, 10) {
+        m_Udp = Net::BindUdp(Net::ParseAddress(options.Bind, options.Port));
+        Net::SetBufferSizes(m_Udp.Get(), 4 << 20);
+        m_Listen = Net::ListenTcp(Net::ParseAddress(options.Bind, Net::LocalPort(m_Udp.Get())));
+
+        m_Epoll.Reset(::epoll_create1(0));
+        m_Timer.Reset(::timerfd_create(CLOCK_MONOTONIC, TFD_NONBLOCK));
+        if (!m_Epoll.IsValid() || !m_Timer.IsValid()) {
+            throw NetError("epoll/timerfd");
+        }
+
+        // tv_nsec has to stay below a second, so slow tick rates need the seconds field
+        const long periodNs = 1'000'000'000L / options.TickRate;
+        itimerspec period   = {};
+        period.it_interval  = {static_cast<time_t>(periodNs / 1'000'000'000),
+                               periodNs % 1'000'000'000};
+        period.it_value     = period.it_interval;
+        if (::timerfd_settime(m_Timer.Get(), 0, &period, nullptr) != 0) {
+            throw NetError("timerfd_settime");
+        }
+
+        Net::EpollAdd(m_Epoll.Get(), m_Timer.Get(), EPOLLIN, kTimerTag);
+        Net::EpollAdd(m_Epoll.Get(), m_Udp.Get(), EPOLLIN, kUdpTag);
+        Net::EpollAdd(m_Epoll.Get(), m_Listen.Get(), EPOLLIN, kListenTag);
+
+        // At most one encoding per baseline in the history plus the keyframe; never reallocates
+        m_Encoded.reserve(kHistorySize + 1);
+    }
+
+    [[nodiscard]] uint16_t Port() const {
+        return Net::LocalPort(m_Udp.Get());
+    }
+
+    [[nodiscard]] SpectatorStats& Stats() {
+        return m_Stats;
+    }
+
+    void Run() {
+        std::vector<epoll_event> events(1024);
+        auto nextSweep = Net::Clock::now() + std::chrono::seconds(1);
+
+        while (!g_Stop) {
+            const int count = ::epoll_wait(m_Epoll.Get(), events.data(), 1024, 100);
+            for (int i = 0; i < count; ++i) {
+                const uint64_t tag = events[i].data.u64;
+                if (tag == kTimerTag) {
+                    OnTimer();
+                } else if (tag == kUdpTag) {
+                    ReceiveUdp();
+                } else if (tag == kListenTag) {
+                    AcceptTcp();
+                } else {
+                    OnTcpEvent(static_cast<int>(tag - kTcpTag), events[i].events);
+                }
+            }
+
+            if (Net::Clock::now() >= nextSweep) {
+                SweepIdleSpectators();
+                nextSweep += std::chrono::seconds(1);
+            }
+        }
+    }
+
+private:
+    struct UdpSpectator {
+        sockaddr_in Address = {};
+        uint32_t AckedTick  = 0;
+        Net::Clock::time_point LastSeen;
+    };
+
+    struct TcpSpectator {
+        UniqueFd Fd;
+        uint32_t SentTick    = 0;  // Baseline: last snapshot written completely
+        uint32_t PendingTick = 0;
+        std::vector<uint8_t> Pending;
+        size_t PendingOffset = 0;
+    };
+
+    // One encoding of the current tick, prefixed with a u16 length for TCP framing
+    struct Encoded {
+        uint32_t BaseTick = 0;
+        std::vector<uint8_t> Framed;
+    };
+
+    Options m_Options;
+    Match m_Match;
+    uint32_t m_Tick = 0;
+    std::array<Snapshot, kHistorySize> m_History = {};
+
+    UniqueFd m_Epoll;
+    UniqueFd m_Timer;
+    UniqueFd m_Udp;
+    UniqueFd m_Listen;
+    Net::FdReserve m_FdReserve;
+
+    CookieJar m_Cookies;
+    std::vector<UdpSpectator> m_UdpSpectators;
+    std::unordered_map<uint64_t, size_t> m_UdpIndex;
+    std::unordered_map<int, TcpSpectator> m_TcpSpectators;
+
+    std::vector<Encoded> m_Encoded;
+    size_t m_EncodedCount = 0;
+
+    SpectatorStats m_Stats;
+
+    static uint64_t AddressKey(const sockaddr_in& address) {
+        return (static_cast<uint64_t>(address.sin_addr.s_addr) << 16) | address.sin_port;
+    }
+
+    // Both paddles simply follow the ball; spectators only care that something is happening
+    static void Autopilot(Match& match) {
+        for (Body* paddle : {&match.Player, &match.Opponent}) {
+            const Scalar offset = match.Ball.Position.Y - paddle->Position.Y;
+            if (offset > kPaddleStep) {
+                Physics::NudgePaddle(*paddle, 1);
+            } else if (offset < -kPaddleStep) {
+                Physics::NudgePaddle(*paddle, -1);
+            }
+        }
+    }
+
+    const Snapshot* FindSnapshot(const uint32_t tick) const {
+        if (tick == 0 || tick > m_Tick || m_Tick - tick >= kHistorySize) {
+            return nullptr;
+        }
+        const Snapshot& snapshot = m_History[tick % kHistorySize];
+        return snapshot.Tick == tick ? &snapshot : nullptr;
+    }
+
+    // Encodes the current tick against `baseTick` once; later callers share the same bytes
+    const std::vector<uint8_t>& EncodedFor(uint32_t baseTick) {
+        static const Snapshot keyframe = {};
+
+        const Snapshot* base = FindSnapshot(baseTick);
+        if (!base) {
+            baseTick = 0;
+            base     = &keyframe;
+        }
+
+        for (size_t i = 0; i < m_EncodedCount; ++i) {
+            if (m_Encoded[i].BaseTick == baseTick) {
+                return m_Encoded[i].Framed;
+            }
+        }
+
+        if (m_EncodedCount == m_Encoded.size()) {
+            m_Encoded.emplace_back();
+        }
+        Encoded& encoded = m_Encoded[m_EncodedCount++];
+        encoded.BaseTick = baseTick;
+        encoded.Framed.assign(2, 0);
+        SnapshotCodec::Encode(*base, m_History[m_Tick % kHistorySize], encoded.Framed);
+        Net::PutU16(encoded.Framed.data(), static_cast<uint16_t>(encoded.Framed.size() - 2));
+
+        m_Stats.Encodes++;
+        return encoded.Framed;
+    }
+
+    void OnTimer() {
+        uint64_t expirations = 0;
+        if (::read(m_Timer.Get(), &expirations, sizeof(expirations)) != sizeof(expirations)) {
+            return;
+        }
+
+        // Catch up on missed ticks, but only broadcast the latest state
+        for (uint64_t i = 0; i < expirations; ++i) {
+            Autopilot(m_Match);
+            m_Match.Tick();
+            if (m_Match.IsOver()) {
+                m_Match.State.Reset(m_Match.State.ScoreLimit);
+            }
+            ++m_Tick;
+            m_History[m_Tick % kHistorySize] = Snapshot::Capture(m_Match, m_Tick);
+        }
+
+        Broadcast();
+    }
+
+    void Broadcast() {
+        const auto start = Net::Clock::now();
+        m_EncodedCount   = 0;
+
+        std::array<mmsghdr, kSendBatch> messages;
+        std::array<iovec, kSendBatch> buffers;
+        size_t batched = 0;
+
+        const auto flush = [&] {
+            size_t sent = 0;
+            while (sent < batched) {
+                const auto pending = static_cast<unsigned>(batched - sent);
+                const int result   = ::sendmmsg(m_Udp.Get(), messages.data() + sent, pending, 0);
+                if (result <= 0) {
+                    break;  // Socket buffer full: those spectators miss this tick
+                }
+                for (int i = 0; i < result; ++i) {
+                    m_Stats.BytesSent += messages[sent + i].msg_len;
+                }
+                m_Stats.MessagesSent += result;
+                sent += result;
+            }
+            batched = 0;
+        };
+
+        for (auto& spectator : m_UdpSpectators) {
+            const auto& framed = EncodedFor(spectator.AckedTick);
+
+            // Skip the TCP length prefix
+            buffers[batched] = {const_cast<uint8_t*>(framed.data()) + 2, framed.size() - 2};
+
+            messages[batched]                     = {};
+            messages[batched].msg_hdr.msg_name    = &spectator.Address;
+            messages[batched].msg_hdr.msg_namelen = sizeof(spectator.Address);
+            messages[batched].msg_hdr.msg_iov     = &buffers[batched];
+            messages[batched].msg_hdr.msg_iovlen  = 1;
+
+            if (++batched == kSendBatch) {
+                flush();
+            }
+        }
+        flush();
+
+        for (auto& [fd, spectator] : m_TcpSpectators) {
+            if (!spectator.Pending.empty()) {
+                continue;  // Still draining an older tick: skip, its baseline stays valid
+            }
+
+            const auto& framed    = EncodedFor(spectator.SentTick);
+            const ssize_t written = ::send(fd, framed.data(), framed.size(), MSG_NOSIGNAL);
+            if (written == static_cast<ssize_t>(framed.size())) {
+                spectator.SentTick = m_Tick;
+            } else {
+                const size_t done = written > 0 ? static_cast<size_t>(written) : 0;
+                spectator.Pending.assign(framed.begin() + static_cast<ptrdiff_t>(done),
+                                         framed.end());
+                spectator.PendingOffset = 0;
+                spectator.PendingTick   = m_Tick;
+                Net::EpollModify(m_Epoll.Get(), fd, EPOLLIN | EPOLLOUT, kTcpTag + fd);
+            }
+            if (written > 0) {
+                m_Stats.BytesSent += static_cast<uint64_t>(written);
+                m_Stats.MessagesSent++;
+            }
+        }
+
+        const auto elapsed = std::chrono::duration<double, std::micro>(Net::Clock::now() - start);
+        m_Stats.TickToSend.Add(elapsed.count());
+        m_Stats.Ticks++;
+        m_Stats.ClientTicks += m_UdpSpectators.size() + m_TcpSpectators.size();
+    }
+
+    void ReceiveUdp() {
+        static constexpr size_t kBatch = 64;
+
+        std::array<std::array<uint8_t, 16>, kBatch> payloads;
+        std::array<sockaddr_in, kBatch> addresses;
+        std::array<iovec, kBatch> buffers;
+        std::array<mmsghdr, kBatch> messages;
+
+        for (;;) {
+            for (size_t i = 0; i < kBatch; ++i) {
+                buffers[i]                      = {payloads[i].data(), payloads[i].size()};
+                messages[i]                     = {};
+                messages[i].msg_hdr.msg_name    = &addresses[i];
+                messages[i].msg_hdr.msg_namelen = sizeof(addresses[i]);
+                messages[i].msg_hdr.msg_iov     = &buffers[i];
+                messages[i].msg_hdr.msg_iovlen  = 1;
+            }
+
+            const int count = ::recvmmsg(m_Udp.Get(), messages.data(), kBatch, 0, nullptr);
+            if (count <= 0) {
+                return;
+            }
+
+            const auto now = Net::Clock::now();
+            for (int i = 0; i < count; ++i) {
+                const auto message = std::span(payloads[i].data(), messages[i].msg_len);
+                OnUdpMessage(addresses[i], message, now);
+            }
+        }
+    }
+
+    void OnUdpMessage(const sockaddr_in& from,
+                      const std::span<const uint8_t> message,
+                      const Net::Clock::time_point now) {
+        if (message.empty()) {
+            return;
+        }
+
+        const uint64_t key = AddressKey(from);
+        const auto it      = m_UdpIndex.find(key);
+
+        switch (message[0]) {
+            case kHelloMessage: {
+                // Short hellos get nothing: the cookie reply must never outgrow its request
+                if (message.size() < kHelloSize) {
+                    break;
+                }
+                if (!m_Cookies.IsValid(from, Net::GetU64(message.data() + 1), now)) {
+                    SendCookie(from, now);
+                    break;
+                }
+
+                if (it != m_UdpIndex.end()) {
+                    m_UdpSpectators[it->second].LastSeen = now;
+                } else if (m_UdpSpectators.size() < m_Options.MaxUdp) {
+                    m_UdpIndex[key] = m_UdpSpectators.size();
+                    m_UdpSpectators.push_back({from, 0, now});
+                } else {
+                    m_Stats.UdpRejected++;
+                }
+                break;
+            }
+            case kAckMessage:
+                if (it != m_UdpIndex.end() && message.size() >= 5) {
+                    auto& spectator    = m_UdpSpectators[it->second];
+                    const uint32_t ack = Net::GetU32(message.data() + 1);
+                    if (ack > spectator.AckedTick && ack <= m_Tick) {
+                        spectator.AckedTick = ack;
+                    }
+                    spectator.LastSeen = now;
+                }
+                break;
+            case kByeMessage:
+                if (it != m_UdpIndex.end()) {
+                    RemoveUdpSpectator(it->second);
+                }
+                break;
+            default:
+                break;
+        }
+    }
+
+    void SendCookie(const sockaddr_in& to, const Net::Clock::time_point now) {
+        uint8_t reply[kHelloSize] = {kCookieMessage};
+        Net::PutU64(reply + 1, m_Cookies.Issue(to, now));
+        ::sendto(m_Udp.Get(),
+                 reply,
+                 sizeof(reply),
+                 0,
+                 reinterpret_cast<const sockaddr*>(&to),
+                 sizeof(to));
+    }
+
+    void RemoveUdpSpectator(const size_t index) {
+        m_UdpIndex.erase(AddressKey(m_UdpSpectators[index].Address));
+        if (index != m_UdpSpectators.size() - 1) {
+            m_UdpSpectators[index]                                 = m_UdpSpectators.back();
+            m_UdpIndex[AddressKey(m_UdpSpectators[index].Address)] = index;
+        }
+        m_UdpSpectators.pop_back();
+    }
+
+    void SweepIdleSpectators() {
+        const auto cutoff = Net::Clock::now() - kSpectatorTimeout;
+        for (size_t i = m_UdpSpectators.size(); i-- > 0;) {
+            if (m_UdpSpectators[i].LastSeen < cutoff) {
+                RemoveUdpSpectator(i);
+            }
+        }
+    }
+
+    void AcceptTcp() {
+        for (;;) {
+            const int fd = ::accept4(m_Listen.Get(), nullptr, nullptr, SOCK_NONBLOCK);
+            if (fd < 0) {
+                if ((errno == EMFILE || errno == ENFILE) && m_FdReserve.Shed(m_Listen.Get())) {
+                    continue;
+                }
+                return;
+            }
+
+            Net::SetNoDelay(fd);
+            Net::EpollAdd(m_Epoll.Get(), fd, EPOLLIN, kTcpTag + fd);
+            m_TcpSpectators[fd].Fd.Reset(fd);
+        }
+    }
+
+    void OnTcpEvent(const int fd, const uint32_t events) {
+        const auto it = m_TcpSpectators.find(fd);
+        if (it == m_TcpSpectators.end()) {
+            return;
+        }
+        auto& spectator = it->second;
+
+        if (events & (EPOLLHUP | EPOLLERR)) {
+            m_TcpSpectators.erase(it);
+            return;
+        }
+
+        if (events & EPOLLIN) {
+            // Acks are not needed on a reliable stream; just watch for the peer closing
+            std::array<uint8_t, 256> discard;
+            const ssize_t count = ::recv(fd, discard.data(), discard.size(), 0);
+            if (count == 0 || (count < 0 && errno != EAGAIN)) {
+                m_TcpSpectators.erase(it);
+                return;
+            }
+        }
+
+        if ((events & EPOLLOUT) && !spectator.Pending.empty()) {
+            const auto remaining  = spectator.Pending.size() - spectator.PendingOffset;
+            const ssize_t written = ::send(fd,
+                                           spectator.Pending.data() + spectator.PendingOffset,
+                                           remaining,
+                                           MSG_NOSIGNAL);
+            if (written < 0 && errno != EAGAIN) {
+                m_TcpSpectators.erase(it);
+                return;
+            }
+            if (written > 0) {
+                spectator.PendingOffset += static_cast<size_t>(written);
+                m_Stats.BytesSent += static_cast<uint64_t>(written);
+            }
+            if (spectator.PendingOffset == spectator.Pending.size()) {
+                spectator.Pending.clear();
+                spectator.SentTick = spectator.PendingTick;
+                Net::EpollModify(m_Epoll.Get(), fd, EPOLLIN, kTcpTag + fd);
+            }
+        }
+    }
+};
+
+/*
+ * Simulated spectators for --bench. Each thread owns a share of the sockets, decodes every
+ * snapshot against its own history and acks it, exactly like a real client would.
+ */
+class SpectatorSwarm {
+public:
+    struct Totals {
+        std::atomic<uint64_t> Snapshots {0};
+        std::atomic<uint64_t> Keyframes {0};
+        std::atomic<uint64_t> DecodeFailures {0};
+        std::atomic<uint64_t> BytesReceived {0};
+    };
+
+    SpectatorSwarm(const uint16_t port,
+                   const int udpClients,
+                   const int tcpClients,
+                   const int threads)
+        : m_Port(port) {
+        for (int t = 0; t < threads; ++t) {
+            const int udp = udpClients / threads + (t < udpClients % threads ? 1 : 0);
+            const int tcp = tcpClients / threads + (t < tcpClients % threads ? 1 : 0);
+            m_Threads.emplace_back([this, udp, tcp] { ClientLoop(udp, tcp); });
+        }
+    }
+
+    ~SpectatorSwarm() {
+        Stop();
+    }
+
+    void Stop() {
+        m_Stop = true;
+        for (auto& thread : m_Threads) {
+            if (thread.joinable()) {
+                thread.join();
+            }
+        }
+    }
+
+    [[nodiscard]] const Totals& Results() const {
+        return m_Totals;
+    }
+
+private:
+    struct Client {
+        UniqueFd Fd;
+        bool IsTcp                                 = false;
+        bool Joined                                = false;
+        uint64_t Cookie                            = 0;
+        std::array<Snapshot, kHistorySize> History = {};
+        std::vector<uint8_t> Stream;  // TCP reassembly
+    };
+
+    uint16_t m_Port;
+    std::vector<std::thread> m_Threads;
+    std::atomic<bool> m_Stop = false;
+    Totals m_Totals;
+
+    void OnSnapshot(Client& client, const std::span<const uint8_t> message) {
+        static const Snapshot keyframe = {};
+
+        uint32_t tick;
+        uint32_t baseTick;
+        if (!SnapshotCodec::PeekTicks(message, tick, baseTick)) {
+            m_Totals.DecodeFailures++;
+            return;
+        }
+
+        const Snapshot& stored = client.History[baseTick % kHistorySize];
+        const Snapshot& base   = baseTick == 0 ? keyframe : stored;
+        Snapshot current;
+        if ((baseTick != 0 && stored.Tick != baseTick) ||
+            !SnapshotCodec::Decode(message, base, current)) {
+            m_Totals.DecodeFailures++;
+            return;
+        }
+
+        client.History[tick % kHistorySize] = current;
+        client.Joined                       = true;
+        m_Totals.Snapshots++;
+        m_Totals.Keyframes += baseTick == 0 ? 1 : 0;
+
+        if (!client.IsTcp) {
+            uint8_t ack[5] = {kAckMessage};
+            Net::PutU32(ack + 1, tick);
+            ::send(client.Fd.Get(), ack, sizeof(ack), 0);
+        }
+    }
+
+    static void SendHello(const Client& client) {
+        uint8_t hello[kHelloSize] = {kHelloMessage};
+        Net::PutU64(hello + 1, client.Cookie);
+        ::send(client.Fd.Get(), hello, sizeof(hello), 0);
+    }
+
+    void ClientLoop(const int udpClients, const int tcpClients) {
+        const auto server = Net::LoopbackAddress(m_Port);
+        const auto* raw   = reinterpret_cast<const sockaddr*>(&server);
+
+        UniqueFd epoll(::epoll_create1(0));
+        std::vector<std::unique_ptr<Client>> clients;
+
+        for (int i = 0; i < udpClients + tcpClients; ++i) {
+            auto client = std::make_unique<Client>();
+            if (i < udpClients) {
+                client->Fd = Net::BindUdp(Net::LoopbackAddress(0));
+                ::connect(client->Fd.Get(), raw, sizeof(server));
+            } else {
+                client->Fd    = Net::ConnectTcp(server);
+                client->IsTcp = true;
+                Net::SetNonBlocking(client->Fd.Get());
+            }
+            Net::EpollAdd(epoll.Get(), client->Fd.Get(), EPOLLIN, clients.size());
+            clients.push_back(std::move(client));
+        }
+
+        std::vector<epoll_event> events(1024);
+        std::array<uint8_t, 4096> buffer;
+        auto nextHello = Net::Clock::now();
+        while (!m_Stop) {
+            // Hellos are datagrams too; keep knocking until the first snapshot arrives
+            if (Net::Clock::now() >= nextHello) {
+                for (const auto& client : clients) {
+                    if (!client->IsTcp && !client->Joined) {
+                        SendHello(*client);
+                    }
+                }
+                nextHello += std::chrono::milliseconds(500);
+            }
+
+            const int count = ::epoll_wait(epoll.Get(), events.data(), 1024, 50);
+            for (int i = 0; i < count; ++i) {
+                Client& client = *clients[events[i].data.u64];
+                for (;;) {
+                    const ssize_t size =
+                      ::recv(client.Fd.Get(), buffer.data(), buffer.size(), MSG_DONTWAIT);
+                    if (size <= 0) {
+                        break;
+                    }
+                    m_Totals.BytesReceived += static_cast<uint64_t>(size);
+
+                    if (!client.IsTcp && buffer[0] == kCookieMessage) {
+                        if (size == kHelloSize) {
+                            client.Cookie = Net::GetU64(buffer.data() + 1);
+                            SendHello(client);
+                        }
+                        continue;
+                    }
+                    if (!client.IsTcp) {
+                        OnSnapshot(client, std::span(buffer.data(), static_cast<size_t>(size)));
+                        continue;
+                    }
+
+                    client.Stream.insert(client.Stream.end(),
+                                         buffer.begin(),
+                                         buffer.begin() + size);
+                    size_t offset = 0;
+                    while (client.Stream.size() - offset >= 2) {
+                        const size_t length = Net::GetU16(client.Stream.data() + offset);
+                        if (client.Stream.size() - offset - 2 < length) {
+                            break;
+                        }
+                        OnSnapshot(client, std::span(client.Stream.data() + offset + 2, length));
+                        offset += 2 + length;
+                    }
+                    client.Stream.erase(client.Stream.begin(),
+                                        client.Stream.begin() + static_cast<ptrdiff_t>(offset));
+                }
+            }
+        }
+
+        for (const auto& client : clients) {
+            if (!client->IsTcp) {
+                const uint8_t bye = kByeMessage;
+                ::send(client->Fd.Get(), &bye, 1, 0);
+            }
+        }
+    }
+};
+
+static Options ParseOptions(const int argc, char** argv) {
+    Options options;
+    for (int i = 1; i < argc; ++i) {
+        const std::string_view arg = argv[i];
+        const bool hasValue        = i + 1 < argc;
+        if (arg == "--bind" && hasValue) {
+            options.Bind = argv[++i];
+        } else if (arg == "--port" && hasValue) {
+            options.Port = static_cast<uint16_t>(std::atoi(argv[++i]));
+        } else if (arg == "--tick-rate" && hasValue) {
+            options.TickRate = std::max(1, std::atoi(argv[++i]));
+        } else if (arg == "--max-spectators" && hasValue) {
+            options.MaxUdp = static_cast<size_t>(std::max(0, std::atoi(argv[++i])));
+        } else if (arg == "--bench" && hasValue) {
+            options.BenchUdpClients = std::atoi(argv[++i]);
+        } else if (arg == "--bench-tcp" && hasValue) {
+            options.BenchTcpClients = std::atoi(argv[++i]);
+        } else if (arg == "--duration" && hasValue) {
+            options.Duration = std::atof(argv[++i]);
+        } else {
+            std::fprintf(stderr, "Unknown argument: %s\n", argv[i]);
+            std::exit(1);
+        }
+    }
+    return options;
+}
+
+static void PrintReport(SpectatorStats& stats, const double seconds) {
+    const auto ticks       = static_cast<double>(stats.Ticks);
+    const auto clientTicks = static_cast<double>(stats.ClientTicks);
+    const double clients   = ticks > 0 ? clientTicks / ticks : 0;
+    const auto bytes       = static_cast<double>(stats.BytesSent);
+    const double perTick   = clientTicks > 0 ? bytes / clientTicks : 0;
+
+    std::printf("ticks:                 %llu\n", static_cast<unsigned long long>(stats.Ticks));
+    std::printf("avg spectators:        %.0f\n", clients);
+    std::printf("messages sent:         %llu\n",
+                static_cast<unsigned long long>(stats.MessagesSent));
+    std::printf("UDP hellos over cap:   %llu\n",
+                static_cast<unsigned long long>(stats.UdpRejected));
+    std::printf("encodes per tick:      %.2f\n",
+                ticks > 0 ? static_cast<double>(stats.Encodes) / ticks : 0);
+    std::printf("bytes/client/s:        %.1f\n", perTick * ticks / seconds);
+    std::printf("tick-to-send p50/p99:  %.1f / %.1f us\n",
+                stats.TickToSend.Percentile(50),
+                stats.TickToSend.Percentile(99));
+}
+
+int main(const int argc, char** argv) {
+    Options options = ParseOptions(argc, argv);
+    std::signal(SIGINT, [](int) { g_Stop = true; });
+    std::signal(SIGTERM, [](int) { g_Stop = true; });
+
+    try {
+        Net::RaiseFdLimit();
+
+        if (options.BenchUdpClients + options.BenchTcpClients == 0) {
+            SpectatorServer server(options);
+            std::printf("Spectator server on %s:%u (UDP + TCP), %d Hz\n",
+                        options.Bind.c_str(),
+                        server.Port(),
+                        options.TickRate);
+            server.Run();
+            return 0;
+        }
+
+        options.Bind   = "127.0.0.1";
+        options.Port   = 0;
+        options.MaxUdp = std::max(options.MaxUdp, static_cast<size_t>(options.BenchUdpClients));
+        SpectatorServer server(options);
+
+        const auto cores  = static_cast<int>(std::thread::hardware_concurrency());
+        const int threads = std::clamp(cores / 2, 1, 4);
+        SpectatorSwarm swarm(server.Port(),
+                             options.BenchUdpClients,
+                             options.BenchTcpClients,
+                             threads);
+
+        std::thread timer([&] {
+            std::this_thread::sleep_for(std::chrono::duration<double>(options.Duration));
+            g_Stop = true;
+        });
+        server.Run();
+        timer.join();
+        swarm.Stop();
+
+        PrintReport(server.Stats(), options.Duration);
+        const auto& results = swarm.Results();
+        std::printf("snapshots decoded:     %llu (%llu keyframes, %llu failures)\n",
+                    static_cast<unsigned long long>(results.Snapshots.load()),
+                    static_cast<unsigned long long>(results.Keyframes.load()),
+                    static_cast<unsigned long long>(results.DecodeFailures.load()));
+    } catch (const std::exception& err) {
+        std::fprintf(stderr, "PongSpectatorServer: %s\n", err.what());
+        return 1;
+    }
+
+    return 0;
+}
@@ -0,0 +1,114 @@
+/*
+ * Checks that the fixed-point simulation still produces the exact same match.
+ *
+ * Usage: DeterminismCheck [--print]
+ *
+ * Plays kTicks fixed updates of a Match with the game's layout and seeded paddle inputs, hashing
+ * every body and the GameState after each tick, and compares the result against kExpectedHash.
+ * Exits non-zero on a mismatch. Any change to Math.h or Simulation.h that alters the outcome of a
+ * match (on purpose or not) shows up here; if it was on purpose, pin the new hash from --print.
+ */
+#include "../Simulation.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <string_view>
+
+static constexpr int kTicks             = 200000;
+static constexpr uint64_t kSeed         = 0x5EED;
+static constexpr uint64_t kExpectedHash = 0x797C71822F605770ull;
+
+// FNV-1a over the raw fixed-point values, so the hash is the same on every platform
+class StateHash {
+public:
+    void Add(const int32_t value) {
+        auto bits = static_cast<uint32_t>(value);
+        for (int i = 0; i < 4; ++i) {
+            m_Hash = (m_Hash ^ (bits & 0xFF)) * 0x100000001B3ull;
+            bits >>= 8;
+        }
+    }
+
+    void Add(const Fixed value) {
+        Add(value.Raw);
+    }
+
+    void Add(const Vector2& value) {
+        Add(value.X);
+        Add(value.Y);
+    }
+
+    void Add(const Body& body) {
+        Add(body.BoundingBox.Left);
+        Add(body.BoundingBox.Top);
+        Add(body.BoundingBox.Right);
+        Add(body.BoundingBox.Bottom);
+        Add(body.Position);
+        Add(body.Size);
+        Add(body.Velocity);
+    }
+
+    void Add(const GameState& state) {
+        Add(state.PlayerScore);
+        Add(state.OpponentScore);
+        Add(state.ScoreLimit);
+    }
+
+    [[nodiscard]] uint64_t Value() const {
+        return m_Hash;
+    }
+
+private:
+    uint64_t m_Hash = 0xCBF29CE484222325ull;
+};
+
+int main(const int argc, char** argv) {
+    bool print = false;
+    for (int i = 1; i < argc; ++i) {
+        if (std::string_view(argv[i]) == "--print") {
+            print = true;
+        } else {
+            std::fputs("Usage: DeterminismCheck [--print]\n", stderr);
+            return 1;
+        }
+    }
+
+    Match match(1920, 1080, 10);
+    uint64_t random = kSeed;
+    StateHash hash;
+
+    for (int tick = 0; tick < kTicks; ++tick) {
+        // Player wanders at random, the opponent follows the ball
+        random = random * 6364136223846793005ull + 1442695040888963407ull;
+        Physics::NudgePaddle(match.Player, static_cast<int>((random >> 33) % 3) - 1);
+
+        const Scalar offset = match.Ball.Position.Y - match.Opponent.Position.Y;
+        if (offset > kPaddleStep || offset < -kPaddleStep) {
+            Physics::NudgePaddle(match.Opponent, offset > Scalar(0) ? 1 : -1);
+        }
+        match.Player.Position.Y = std::clamp(match.Player.Position.Y, Scalar(0), match.Height);
+
+        const Scorer scorer = match.Tick();
+        if (match.IsOver()) {
+            match.State.Reset(match.State.ScoreLimit);
+        }
+
+        hash.Add(static_cast<int32_t>(scorer));
+        hash.Add(match.Ball);
+        hash.Add(match.Player);
+        hash.Add(match.Opponent);
+        hash.Add(match.State);
+    }
+
+    const bool matches = hash.Value() == kExpectedHash;
+    if (print || !matches) {
+        std::printf("hash:     0x%016llx\n", static_cast<unsigned long long>(hash.Value()));
+        std::printf("expected: 0x%016llx\n", static_cast<unsigned long long>(kExpectedHash));
+    }
+    if (!matches) {
+        std::fprintf(stderr, "DeterminismCheck: simulation diverged after %d ticks\n", kTicks);
+        return 1;
+    }
+    std::printf("DeterminismCheck: %d ticks match\n", kTicks);
+    return 0;
+}
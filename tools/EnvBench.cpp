@@ -0,0 +1,150 @@
+/*
+ * Throughput of the PongEnv library through its C ABI.
+ *
+ * Usage: EnvBench [--envs N] [--steps N] [--pixels SIZE] [--seed N]
+ *
+ * Steps N environments with random actions and reports environment steps per second and per
+ * core of CPU time (the library is single-threaded; run one instance per core to scale out).
+ * --pixels also renders SIZE x SIZE frames every step. Finally replays the start of the run on a
+ * second instance with the same seed and checks that every output byte matches.
+ */
+#include "../env/PongEnv.h"
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+#include <string_view>
+#include <vector>
+
+struct Outputs {
+    std::vector<float> Observations;
+    std::vector<uint8_t> Pixels;
+    std::vector<float> Rewards;
+    std::vector<uint8_t> Dones;
+    PongEnvBuffers Buffers = {};
+
+    explicit Outputs(const PongEnvConfig& config) {
+        const size_t frame = static_cast<size_t>(config.PixelWidth) * config.PixelHeight;
+        Observations.resize(config.EnvCount * PONG_OBS_SIZE);
+        Pixels.resize(config.EnvCount * frame);
+        Rewards.resize(config.EnvCount);
+        Dones.resize(config.EnvCount);
+
+        Buffers.Observations = Observations.data();
+        Buffers.Pixels       = frame != 0 ? Pixels.data() : nullptr;
+        Buffers.Rewards      = Rewards.data();
+        Buffers.Dones        = Dones.data();
+    }
+
+    bool operator==(const Outputs& other) const {
+        return Observations == other.Observations && Pixels == other.Pixels &&
+               Rewards == other.Rewards && Dones == other.Dones;
+    }
+};
+
+// Deterministic stand-in for a policy: -1, 0 or 1
+static void RandomActions(uint64_t& state, std::vector<int32_t>& actions) {
+    for (auto& action : actions) {
+        state  = state * 6364136223846793005ull + 1442695040888963407ull;
+        action = static_cast<int32_t>((state >> 33) % 3) - 1;
+    }
+}
+
+int main(const int argc, char** argv) {
+    PongEnvConfig config;
+    PongEnvDefaultConfig(&config);
+    config.EnvCount = 256;
+
+    int steps     = 20000;
+    uint64_t seed = 1;
+    for (int i = 1; i < argc; ++i) {
+        const std::string_view arg = argv[i];
+        const bool hasValue        = i + 1 < argc;
+        if (arg == "--envs" && hasValue) {
+            config.EnvCount = static_cast<uint32_t>(std::atoi(argv[++i]));
+        } else if (arg == "--steps" && hasValue) {
+            steps = std::atoi(argv[++i]);
+        } else if (arg == "--pixels" && hasValue) {
+            config.PixelWidth  = static_cast<uint32_t>(std::atoi(argv[++i]));
+            config.PixelHeight = config.PixelWidth;
+        } else if (arg == "--seed" && hasValue) {
+            seed = std::strtoull(argv[++i], nullptr, 10);
+        } else {
+            std::fputs("Usage: EnvBench [--envs N] [--steps N] [--pixels SIZE] [--seed N]\n",
+                       stderr);
+            return 1;
+        }
+    }
+
+    if (PongEnvApiVersion() != PONG_ENV_API_VERSION) {
+        std::fprintf(stderr, "EnvBench: library API version %u, expected %u\n",
+                     PongEnvApiVersion(),
+                     PONG_ENV_API_VERSION);
+        return 1;
+    }
+
+    PongEnv* env = nullptr;
+    if (const int result = PongEnvCreate(&config, &env); result != PONG_ENV_OK) {
+        std::fprintf(stderr, "EnvBench: PongEnvCreate failed (%d)\n", result);
+        return 1;
+    }
+
+    Outputs outputs(config);
+    std::vector<int32_t> actions(config.EnvCount);
+    uint64_t actionState = seed;
+    PongEnvReset(env, seed, &outputs.Buffers);
+
+    // Snapshot early outputs for the determinism check
+    constexpr int kReplaySteps = 1000;
+    const int replaySteps      = steps < kReplaySteps ? steps : kReplaySteps;
+    Outputs replayed(config);
+
+    uint64_t episodes = 0;
+    double reward     = 0;
+
+    const auto wallStart        = std::chrono::steady_clock::now();
+    const std::clock_t cpuStart = std::clock();
+    for (int step = 0; step < steps; ++step) {
+        RandomActions(actionState, actions);
+        PongEnvStep(env, actions.data(), &outputs.Buffers);
+
+        for (uint32_t i = 0; i < config.EnvCount; ++i) {
+            episodes += outputs.Dones[i];
+            reward += outputs.Rewards[i];
+        }
+        if (step + 1 == replaySteps) {
+            replayed = outputs;
+        }
+    }
+    const double cpuSeconds = static_cast<double>(std::clock() - cpuStart) / CLOCKS_PER_SEC;
+    const double wallSeconds =
+      std::chrono::duration<double>(std::chrono::steady_clock::now() - wallStart).count();
+    PongEnvDestroy(env);
+
+    // Same seed and actions on a fresh instance must reproduce the same bytes
+    PongEnv* replay = nullptr;
+    PongEnvCreate(&config, &replay);
+    Outputs check(config);
+    actionState = seed;
+    PongEnvReset(replay, seed, &check.Buffers);
+    for (int step = 0; step < replaySteps; ++step) {
+        RandomActions(actionState, actions);
+        PongEnvStep(replay, actions.data(), &check.Buffers);
+    }
+    PongEnvDestroy(replay);
+
+    const double total = static_cast<double>(steps) * config.EnvCount;
+    std::printf("envs x steps:         %u x %d", config.EnvCount, steps);
+    if (config.PixelWidth != 0) {
+        std::printf(" (%ux%u frames)", config.PixelWidth, config.PixelHeight);
+    }
+    std::printf("\n");
+    std::printf("steps/s:              %.0f\n", total / wallSeconds);
+    std::printf("steps/s/core:         %.0f\n", cpuSeconds > 0 ? total / cpuSeconds : 0);
+    std::printf("episodes finished:    %llu\n", static_cast<unsigned long long>(episodes));
+    std::printf("mean reward/step:     %.5f\n", reward / total);
+    std::printf("deterministic:        %s\n", check == replayed ? "yes" : "NO");
+    return check == replayed ? 0 : 1;
+}
@@ -0,0 +1,176 @@
+/*
+ * Packs every file under an assets directory into a single archive (see AssetArchive.h).
+ *
+ * Usage: PackAssets <assets dir> <output file> [--compress EXT]...
+ *
+ * Files with an extension given to --compress (e.g. ".ttf") are LZ4 compressed when that actually
+ * saves space. Everything else is stored as is, so the game can keep using it straight from the
+ * mapped archive without a copy; audio (.wav) should stay uncompressed. Entries are written in
+ * path order so the output is reproducible.
+ *
+ * The finished archive is opened again with AssetArchive and every entry is compared with its
+ * source file, so a writer/reader mismatch fails the build instead of the game's startup.
+ */
+#include "../AssetArchive.h"
+
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <set>
+
+namespace fs = std::filesystem;
+
+static std::vector<uint8_t> ReadFile(const fs::path& path) {
+    std::ifstream file(path, std::ios::binary);
+    return {std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>()};
+}
+
+static void Write(std::ofstream& out, const std::span<const uint8_t> bytes) {
+    const auto size = static_cast<std::streamsize>(bytes.size());
+    out.write(reinterpret_cast<const char*>(bytes.data()), size);
+}
+
+// Reads the archive back the way the game does. Returns false (and says why) on any mismatch.
+static bool Verify(const fs::path& output, const std::map<std::string, fs::path>& files) {
+    AssetArchive archive;
+    try {
+        archive.Open(output.string().c_str());
+    } catch (const AssetError& err) {
+        std::cerr << "PackAssets: " << output << " does not read back: " << err.what() << "\n";
+        return false;
+    }
+
+    for (const auto& [name, path] : files) {
+        const auto asset = archive.Get(AssetIdOf(name));
+        if (!asset) {
+            std::cerr << "PackAssets: " << name << " does not read back from " << output << "\n";
+            return false;
+        }
+        if (!std::ranges::equal(*asset, ReadFile(path))) {
+            std::cerr << "PackAssets: " << name << " reads back different bytes\n";
+            return false;
+        }
+    }
+    return true;
+}
+
+static void Pad(std::ofstream& out, uint64_t& offset) {
+    static constexpr char zeros[kArchiveAlignment] = {};
+    const uint64_t padding = (kArchiveAlignment - offset % kArchiveAlignment) % kArchiveAlignment;
+    out.write(zeros, static_cast<std::streamsize>(padding));
+    offset += padding;
+}
+
+int main(int argc, char** argv) {
+    static constexpr auto kUsage =
+      "Usage: PackAssets <assets dir> <output file> [--compress EXT]...\n";
+    if (argc < 3) {
+        std::cerr << kUsage;
+        return 1;
+    }
+
+    const fs::path assetDir = argv[1];
+    const fs::path output   = argv[2];
+
+    std::set<std::string> compressed;
+    for (int i = 3; i < argc; ++i) {
+        if (std::string_view(argv[i]) == "--compress" && i + 1 < argc) {
+            compressed.insert(argv[++i]);
+        } else {
+            std::cerr << kUsage;
+            return 1;
+        }
+    }
+
+    if (!fs::is_directory(assetDir)) {
+        std::cerr << "PackAssets: " << assetDir << " is not a directory\n";
+        return 1;
+    }
+
+    std::map<std::string, fs::path> files;
+    for (const auto& item : fs::recursive_directory_iterator(assetDir)) {
+        if (item.is_regular_file()) {
+            files[fs::relative(item.path(), assetDir).generic_string()] = item.path();
+        }
+    }
+
+    if (output.has_parent_path()) {
+        fs::create_directories(output.parent_path());
+    }
+
+    std::ofstream out(output, std::ios::binary | std::ios::trunc);
+    if (!out.is_open()) {
+        std::cerr << "PackAssets: failed to open " << output << " for writing\n";
+        return 1;
+    }
+
+    ArchiveHeader header = {};
+    out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    uint64_t offset = sizeof(header);
+
+    std::unordered_map<AssetId, std::string> ids;
+    std::vector<ArchiveEntry> entries;
+    for (const auto& [name, path] : files) {
+        const AssetId id = AssetIdOf(name);
+        if (const auto [it, inserted] = ids.emplace(id, name); !inserted) {
+            std::cerr << "PackAssets: asset id collision between " << it->second << " and " << name
+                      << "\n";
+            return 1;
+        }
+
+        std::vector<uint8_t> data = ReadFile(path);
+
+        ArchiveEntry entry = {};
+        entry.Id           = id;
+        entry.Size         = data.size();
+
+        if (compressed.contains(path.extension().string())) {
+            auto packed = Lz4::Compress(data);
+            if (packed.size() < data.size()) {
+                data = std::move(packed);
+                entry.Flags |= kEntryCompressed;
+            }
+        }
+
+        Pad(out, offset);
+        entry.Offset     = offset;
+        entry.StoredSize = data.size();
+        entry.Checksum   = Fnv1a(data);
+        Write(out, data);
+        offset += data.size();
+
+        entries.push_back(entry);
+        std::cout << "PackAssets: " << name << " (" << entry.Size << " -> " << entry.StoredSize
+                  << " bytes)\n";
+    }
+
+    std::ranges::sort(entries, {}, &ArchiveEntry::Id);
+
+    Pad(out, offset);
+    const auto indexBytes = std::span(reinterpret_cast<const uint8_t*>(entries.data()),
+                                      entries.size() * sizeof(ArchiveEntry));
+    Write(out, indexBytes);
+
+    std::memcpy(header.Magic, kArchiveMagic, sizeof(kArchiveMagic));
+    header.Version       = kArchiveVersion;
+    header.EntryCount    = static_cast<uint32_t>(entries.size());
+    header.IndexOffset   = offset;
+    header.IndexChecksum = Fnv1a(indexBytes);
+    out.seekp(0);
+    out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+
+    out.close();
+    if (!out.good()) {
+        std::cerr << "PackAssets: failed to write " << output << "\n";
+        return 1;
+    }
+
+    // Don't leave a bad archive behind for the next build to pick up as up to date
+    if (!Verify(output, files)) {
+        fs::remove(output);
+        return 1;
+    }
+
+    return 0;
+}
@@ -0,0 +1,114 @@
+/*
+ * Measures how many pixels the game's incremental renderer touches per frame (see Damage.h).
+ *
+ * Usage: RenderDamageBench [--frames N] [--ticks-per-frame N] [--width W] [--height H]
+ *
+ * Plays a headless match with the game's object layout and feeds the same damage the renderer
+ * collects (ball, both paddles and the score text) into a DamageRegion once per frame. The game
+ * runs a fixed update about every millisecond and renders at 60 FPS, so by default a frame sees
+ * the damage of 16 ticks. Paddle input arrives every 8 ticks, like the game's input dispatcher:
+ * the player paddle sweeps up and down like someone holding a key; the opponent tracks the ball.
+ */
+#include "../Damage.h"
+#include "../Simulation.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <string_view>
+
+static constexpr int kInputPeriod = 8;  // Ticks between paddle nudges (InputDispatcher sleeps 8 ms)
+
+int main(const int argc, char** argv) {
+    int frames        = 100000;
+    int ticksPerFrame = 16;  // 1 ms fixed updates at 60 FPS
+    int width         = 1920;
+    int height        = 1080;
+    for (int i = 1; i < argc; ++i) {
+        const std::string_view arg = argv[i];
+        if (arg == "--frames" && i + 1 < argc) {
+            frames = std::atoi(argv[++i]);
+        } else if (arg == "--ticks-per-frame" && i + 1 < argc) {
+            ticksPerFrame = std::max(1, std::atoi(argv[++i]));
+        } else if (arg == "--width" && i + 1 < argc) {
+            width = std::atoi(argv[++i]);
+        } else if (arg == "--height" && i + 1 < argc) {
+            height = std::atoi(argv[++i]);
+        } else {
+            std::fputs("Usage: RenderDamageBench [--frames N] [--ticks-per-frame N] [--width W] "
+                       "[--height H]\n",
+                       stderr);
+            return 1;
+        }
+    }
+
+    Match match(width, height, 10);
+    DamageRegion damage;
+
+    // Same paint bounds as the game objects in main.cpp
+    const auto scoreText = [&] { return Rect {0, 0, match.Width, 140}; };
+    Rect ball            = Rect::FromCenter(match.Ball.Position, match.Ball.Size);
+    Rect player          = match.Player.BoundingBox;
+    Rect opponent        = match.Opponent.BoundingBox;
+    int score            = -1;
+
+    int64_t pixelsTouched = 0;
+    int64_t rects         = 0;
+    int fullRedraws       = 0;
+    int64_t tick          = 0;
+
+    for (int frame = 0; frame < frames; ++frame) {
+        for (int step = 0; step < ticksPerFrame; ++step, ++tick) {
+            if (tick % kInputPeriod == 0) {
+                Physics::NudgePaddle(match.Player, (frame / 30) % 2 == 0 ? -1 : 1);
+                const Scalar offset = match.Ball.Position.Y - match.Opponent.Position.Y;
+                if (offset > kPaddleStep || offset < -kPaddleStep) {
+                    Physics::NudgePaddle(match.Opponent, offset > Scalar(0) ? 1 : -1);
+                }
+            }
+
+            match.Tick();
+            if (match.IsOver()) {
+                match.State.Reset(match.State.ScoreLimit);
+            }
+        }
+        match.Player.UpdateBoundingBox();
+        match.Opponent.UpdateBoundingBox();
+
+        damage.Begin(width, height);
+
+        const Rect ballNow = Rect::FromCenter(match.Ball.Position, match.Ball.Size);
+        damage.AddMove(ball, ballNow);
+        damage.AddMove(player, match.Player.BoundingBox);
+        damage.AddMove(opponent, match.Opponent.BoundingBox);
+        if (match.State.TotalScore() != score) {
+            damage.Add(ToPixelRect(scoreText()));
+        }
+
+        ball     = ballNow;
+        player   = match.Player.BoundingBox;
+        opponent = match.Opponent.BoundingBox;
+        score    = match.State.TotalScore();
+
+        pixelsTouched += damage.PixelsTouched();
+        rects += damage.IsFullRedraw() ? 1 : static_cast<int64_t>(damage.Rects().size());
+        fullRedraws += damage.IsFullRedraw() ? 1 : 0;
+    }
+
+    const double full     = static_cast<double>(Area(damage.Surface()));
+    const double perFrame = frames > 0 ? static_cast<double>(pixelsTouched) / frames : 0;
+    std::printf("frames:               %d at %dx%d, %d ticks each\n",
+                frames,
+                width,
+                height,
+                ticksPerFrame);
+    std::printf("full redraw:          %.0f px/frame\n", full);
+    std::printf("incremental:          %.0f px/frame (%.2f%% of full, %.1fx less)\n",
+                perFrame,
+                100.0 * perFrame / full,
+                perFrame > 0 ? full / perFrame : 0);
+    std::printf("rects per frame:      %.2f\n",
+                frames > 0 ? static_cast<double>(rects) / frames : 0);
+    std::printf("full redraws:         %d\n", fullRedraws);
+    return 0;
+}
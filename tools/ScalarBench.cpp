@@ -0,0 +1,75 @@
+/*
+ * Throughput of the simulation with float against Fixed scalars.
+ *
+ * Usage: ScalarBench [--matches N] [--ticks N]
+ *
+ * Runs the same headless matches (BasicMatch from Simulation.h) once per scalar type with the same
+ * seeded paddle inputs and reports fixed updates per second for each, i.e. what the bit-identical
+ * Q16.16 arithmetic costs over hardware floats.
+ */
+#include "../Simulation.h"
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <string_view>
+#include <vector>
+
+template<typename T>
+static double TicksPerSecond(const int matchCount, const int ticks, int& points) {
+    std::vector<BasicMatch<T>> matches(matchCount, BasicMatch<T>(T(1920), T(1080), 10));
+    uint64_t random = 1;
+
+    const auto start = std::chrono::steady_clock::now();
+    for (int tick = 0; tick < ticks; ++tick) {
+        for (auto& match : matches) {
+            // The player wanders at random and the opponent follows the ball, so there are both
+            // returns and points
+            random = random * 6364136223846793005ull + 1442695040888963407ull;
+            Physics::NudgePaddle(match.Player, static_cast<int>((random >> 33) % 3) - 1);
+
+            const T offset = match.Ball.Position.Y - match.Opponent.Position.Y;
+            if (offset > Tuning<T>::PaddleStep || offset < -Tuning<T>::PaddleStep) {
+                Physics::NudgePaddle(match.Opponent, offset > T(0) ? 1 : -1);
+            }
+
+            if (match.Tick() != Scorer::None) {
+                points++;
+            }
+            if (match.IsOver()) {
+                match.State.Reset(match.State.ScoreLimit);
+            }
+        }
+    }
+    const double seconds =
+      std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    return static_cast<double>(matchCount) * ticks / seconds;
+}
+
+int main(const int argc, char** argv) {
+    int matchCount = 1000;
+    int ticks      = 10000;
+    for (int i = 1; i < argc; ++i) {
+        const std::string_view arg = argv[i];
+        if (arg == "--matches" && i + 1 < argc) {
+            matchCount = std::atoi(argv[++i]);
+        } else if (arg == "--ticks" && i + 1 < argc) {
+            ticks = std::atoi(argv[++i]);
+        } else {
+            std::fputs("Usage: ScalarBench [--matches N] [--ticks N]\n", stderr);
+            return 1;
+        }
+    }
+
+    // Points scored are printed so neither run can be optimized away
+    int floatPoints       = 0;
+    int fixedPoints       = 0;
+    const double floatTps = TicksPerSecond<float>(matchCount, ticks, floatPoints);
+    const double fixedTps = TicksPerSecond<Fixed>(matchCount, ticks, fixedPoints);
+
+    std::printf("matches x ticks:      %d x %d\n", matchCount, ticks);
+    std::printf("float ticks/s:        %.0f (%d points)\n", floatTps, floatPoints);
+    std::printf("Fixed ticks/s:        %.0f (%d points)\n", fixedTps, fixedPoints);
+    std::printf("Fixed / float:        %.2f\n", fixedTps / floatTps);
+    return 0;
+}